@@ -0,0 +1,78 @@
+//
+//  AbstractData+Probe.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+// Non throwing probes for optional tags. The `get…ForTagString` accessors report an absent tag
+// by allocating an `NSError`; these return `false` / `nil` instead and never allocate an error
+// for the tag classes known to `EMVQRTagTable`.
+
+extension AbstractData {
+    func hasValue(forTagString tagString: String) -> Bool {
+        guard let tagInfo = TagUtility.tagInfo(forTag: tagString, of: tagType) else {
+            return false
+        }
+        return hasTagInfoValue(for: tagInfo)
+    }
+
+    func tryGetValue(forTagString tagString: String) -> Any? {
+        guard let tagInfo = TagUtility.tagInfo(forTag: tagString, of: tagType),
+              hasTagInfoValue(for: tagInfo) else {
+            return nil
+        }
+        return getTagInfoValue(for: tagInfo)
+    }
+
+    /// Value of `tagString` if it lies in `range`
+    fileprivate func tryGetValue(forTagString tagString: String, in range: ClosedRange<UInt8>) -> Any? {
+        guard let tag = EMVQRTagTable.tag(from: tagString), range.contains(tag) else {
+            return nil
+        }
+        return tryGetValue(forTagString: tagString)
+    }
+}
+
+extension PushPaymentData {
+    func hasMerchantIdentifierEMVCOData(forTagString tagString: String) -> Bool {
+        tryGetMerchantIdentifierEMVCOData(forTagString: tagString) != nil
+    }
+
+    /// Non throwing `getMerchantIdentifierEMVCOData(forTagString:)`, tags 26...51
+    func tryGetMerchantIdentifierEMVCOData(forTagString tagString: String) -> String? {
+        tryGetValue(forTagString: tagString, in: EMVQRPayload.Tags.merchantAccountInformation) as? String
+    }
+
+    func hasMAIData(forTagString tagString: String) -> Bool {
+        tryGetMAIData(forTagString: tagString) != nil
+    }
+
+    /// Non throwing `getMAIData(forTagString:)`, tags 26...51
+    func tryGetMAIData(forTagString tagString: String) -> MAIData? {
+        tryGetValue(forTagString: tagString, in: EMVQRPayload.Tags.merchantAccountInformation) as? MAIData
+    }
+
+    func hasUnreservedData(forTagString tagString: String) -> Bool {
+        tryGetUnreservedData(forTagString: tagString) != nil
+    }
+
+    /// Non throwing `getUnreservedData(forTagString:)`, tags 80...99
+    func tryGetUnreservedData(forTagString tagString: String) -> UnrestrictedData? {
+        tryGetValue(forTagString: tagString, in: EMVQRPayload.Tags.unreservedTemplates) as? UnrestrictedData
+    }
+}
+
+extension AdditionalData {
+    static let unreservedSubTags: ClosedRange<UInt8> = 50...99
+
+    func hasUnreservedData(forSubTag tag: String) -> Bool {
+        tryGetUnreservedData(forSubTag: tag) != nil
+    }
+
+    /// Non throwing `getUnreservedData(forSubTag:)`, sub tags 50...99
+    func tryGetUnreservedData(forSubTag tag: String) -> UnrestrictedData? {
+        tryGetValue(forTagString: tag, in: AdditionalData.unreservedSubTags) as? UnrestrictedData
+    }
+}
@@ -0,0 +1,34 @@
+//
+//  ChecksumUtility+CRC16.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+extension ChecksumUtility {
+    /// Same result as `crc16(_:)`, computed by `EMVQRCRC16` directly on the UTF-8 bytes
+    static func crc16(bytes: [UInt8]) -> String {
+        EMVQRCRC16.hexString(EMVQRCRC16.checksum(bytes))
+    }
+
+    /// Same result as `isValidCrc16(_:)`, without bridging the payload to `NSString`
+    static func isValidCrc16(bytes: [UInt8]) -> Bool {
+        bytes.withUnsafeBytes { EMVQRCRC16.isValid(payload: $0) }
+    }
+}
+
+extension ChecksumUtility {
+    /// CRC16 state after hashing `prefix`, to be resumed with `crc16(resuming:suffix:)`
+    static func crc16Checkpoint(prefix: [UInt8]) -> UInt16 {
+        var crc = EMVQRCRC16()
+        crc.update(prefix)
+        return crc.value
+    }
+
+    /// CRC16 of a payload whose prefix state is `checkpoint`, over `suffix` and the `6304` trailer,
+    /// in the 4 digit hex format of tag 63
+    static func crc16(resuming checkpoint: UInt16, suffix: [UInt8]) -> String {
+        EMVQRCRC16.hexString(EMVQRCRC16(resumingFrom: checkpoint).finalized(appending: suffix))
+    }
+}
@@ -0,0 +1,31 @@
+//
+//  ChecksumUtility+Luhn.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+extension ChecksumUtility {
+    /// Batch `validateLuhnChecksum(_:)`. Each identifier must include its check digit;
+    /// non numeric identifiers are invalid.
+    static func validateLuhnChecksums(_ identifiers: [String]) -> [Bool] {
+        identifiers.map { identifier in
+            var identifier = identifier
+            return identifier.withUTF8 { EMVQRLuhn.isValid(UnsafeRawBufferPointer($0)) }
+        }
+    }
+
+    /// Batch validation of fixed width identifiers packed back to back in `packed`,
+    /// e.g. a column read straight from an onboarding file. Returns `[]` for a `width` below 1.
+    static func validateLuhnChecksums(packed: [UInt8], width: Int) -> [Bool] {
+        guard width > 0 else {
+            return []
+        }
+        let count = packed.count / width
+        return [Bool](unsafeUninitializedCapacity: count) { results, initializedCount in
+            packed.withUnsafeBytes { EMVQRLuhn.validate(packed: $0, width: width, into: results) }
+            initializedCount = count
+        }
+    }
+}
@@ -0,0 +1,94 @@
+//
+//  EMVQRAIDRouter.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Maps AIDs (sub tag 00 of merchant account templates 26...51) or AID prefixes to handlers,
+/// e.g. `A000000677010112` or `abaakhppxxx@abaa` to the rail that pays them.
+/// Prefixes are kept in a sorted array built once; a lookup is a binary search plus a walk
+/// up the chain of shorter prefixes, matched directly on payload bytes.
+struct EMVQRAIDRouter<Handler> {
+    private let prefixes: [[UInt8]]
+    private let handlers: [Handler]
+    /// Index of the longest other prefix that is a prefix of this one, or -1
+    private let parents: [Int]
+
+    /// Later routes replace earlier ones with the same prefix
+    init(routes: [(prefix: String, handler: Handler)]) {
+        var unique: [[UInt8]: Handler] = [:]
+        for route in routes {
+            unique[Array(route.prefix.utf8)] = route.handler
+        }
+        let sorted = unique.sorted { $0.key.lexicographicallyPrecedes($1.key) }
+        prefixes = sorted.map { $0.key }
+        handlers = sorted.map { $0.value }
+
+        var parents = [Int](repeating: -1, count: sorted.count)
+        var stack: [Int] = []
+        for index in prefixes.indices {
+            while let last = stack.last, !prefixes[index].starts(with: prefixes[last]) {
+                stack.removeLast()
+            }
+            parents[index] = stack.last ?? -1
+            stack.append(index)
+        }
+        self.parents = parents
+    }
+
+    /// Handler of the longest prefix of `aid`
+    func handler<Bytes: RandomAccessCollection>(forAID aid: Bytes) -> Handler? where Bytes.Element == UInt8 {
+        var low = 0
+        var high = prefixes.count
+        while low < high {
+            let middle = (low + high) / 2
+            if aid.lexicographicallyPrecedes(prefixes[middle]) {
+                high = middle
+            } else {
+                low = middle + 1
+            }
+        }
+
+        var index = low - 1
+        while index >= 0 {
+            if aid.starts(with: prefixes[index]) {
+                return handlers[index]
+            }
+            index = parents[index]
+        }
+        return nil
+    }
+
+    func handler(forAID aid: String) -> Handler? {
+        handler(forAID: Array(aid.utf8))
+    }
+
+    /// Scans `payload` and returns the handler of the first merchant account, in payload order, whose AID is routed
+    /// - Note: Throws `EMVQRError.invalidFormat` on a malformed payload. The CRC is not checked.
+    func route(payload: UnsafeRawBufferPointer) throws -> (tag: UInt8, handler: Handler)? {
+        let tags = EMVQRPayload.Tags.self
+        var scanner = EMVQRScanner(bytes: payload)
+        while let span = try scanner.next() {
+            guard tags.merchantAccountInformation.contains(span.tag) else {
+                continue
+            }
+            var nested = EMVQRScanner(bytes: payload, range: span.offset..<span.end)
+            while let sub = try nested.next() {
+                guard sub.tag == tags.globallyUniqueIdentifier else {
+                    continue
+                }
+                if let handler = handler(forAID: UnsafeRawBufferPointer(rebasing: payload[sub.offset..<sub.end])) {
+                    return (span.tag, handler)
+                }
+                break
+            }
+        }
+        return nil
+    }
+
+    func route(payload: String) throws -> (tag: UInt8, handler: Handler)? {
+        var payload = payload
+        return try payload.withUTF8 { try route(payload: UnsafeRawBufferPointer($0)) }
+    }
+}
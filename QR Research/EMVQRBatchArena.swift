@@ -0,0 +1,148 @@
+//
+//  EMVQRBatchArena.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Region holding the parse results of one batch.
+/// All payload bytes go to one byte slab and all structural tapes to one entry slab; an item is a pair of ranges
+/// into them, and an error is a plain `EMVQRError`. Every element is a trivial value, so the region is three
+/// heap blocks however large the batch, and `reset()` or dropping the arena frees it without visiting any item.
+/// - Note: Not thread safe. Fill one arena per batch and read it afterwards, from any thread.
+final class EMVQRBatchArena {
+    struct Item {
+        /// Bytes of the payload in `bytes`
+        let payload: Range<Int>
+        /// Entries of the payload's tape in `entries`, empty on error. Entry offsets count from `payload.lowerBound`.
+        let entries: Range<Int>
+        /// Offsets count from `payload.lowerBound`
+        let error: EMVQRError?
+    }
+
+    private(set) var bytes: [UInt8] = []
+    private(set) var entries: [EMVQRTape.Entry] = []
+    private(set) var items: [Item] = []
+
+    init(reservingCapacity count: Int = 0, averagePayloadSize: Int = 256, averageEntryCount: Int = 16) {
+        reserveCapacity(count, averagePayloadSize: averagePayloadSize, averageEntryCount: averageEntryCount)
+    }
+
+    var count: Int {
+        items.count
+    }
+
+    /// - Parameter averageEntryCount: Tape entries per payload, template children included; a merchant QR has 12 to 20
+    func reserveCapacity(_ count: Int, averagePayloadSize: Int = 256, averageEntryCount: Int = 16) {
+        reserveCapacity(count, payloadBytes: count * averagePayloadSize, averageEntryCount: averageEntryCount)
+    }
+
+    /// - Parameter payloadBytes: Total UTF-8 size of the payloads to append
+    func reserveCapacity(_ count: Int, payloadBytes: Int, averageEntryCount: Int = 16) {
+        bytes.reserveCapacity(payloadBytes)
+        entries.reserveCapacity(count * averageEntryCount)
+        items.reserveCapacity(count)
+    }
+
+    /// Releases every item at once. The slabs keep their capacity for the next batch.
+    func reset() {
+        bytes.removeAll(keepingCapacity: true)
+        entries.removeAll(keepingCapacity: true)
+        items.removeAll(keepingCapacity: true)
+    }
+
+    /// Copies `string` into the byte slab and appends its tape
+    /// - Parameter validatesCRC: Rejects the payload on its CRC trailer before scanning, as `parseFailFast` does
+    @discardableResult
+    func append(_ string: String, validatesCRC: Bool = true) -> Item {
+        let payloadStart = bytes.count
+        bytes.append(contentsOf: string.utf8)
+        let payload = payloadStart..<bytes.count
+
+        let entriesStart = entries.count
+        var failure: EMVQRError?
+        do {
+            try bytes.withUnsafeBytes { slab in
+                let buffer = UnsafeRawBufferPointer(rebasing: slab[payload])
+                if validatesCRC {
+                    try EMVQRCRC16.validateTrailer(of: buffer)
+                }
+                try EMVQRTape.scan(buffer, range: 0..<buffer.count, into: &entries)
+            }
+        } catch {
+            // The trailer check and the scan only throw EMVQRError
+            failure = error as? EMVQRError ?? .invalidFormat(offset: 0)
+            entries.removeSubrange(entriesStart...)
+        }
+
+        let item = Item(payload: payload, entries: entriesStart..<entries.count, error: failure)
+        items.append(item)
+        return item
+    }
+
+    // MARK: - Reading items
+
+    /// Index in `entries` of the top level object `tag` of item `index`
+    func entryIndex(of tag: UInt8, inItem index: Int) -> Int? {
+        var entry = items[index].entries.lowerBound
+        let end = items[index].entries.upperBound
+        while entry < end {
+            if entries[entry].tag == tag {
+                return entry
+            }
+            entry = Int(entries[entry].next)
+        }
+        return nil
+    }
+
+    /// Index in `entries` of the object `tag` inside the template at entry `parent`
+    func entryIndex(of tag: UInt8, in parent: Int) -> Int? {
+        (parent + 1..<Int(entries[parent].next)).first { entries[$0].tag == tag }
+    }
+
+    /// Value of entry `entry`, which belongs to item `index`
+    func value(atEntry entry: Int, inItem index: Int) -> String {
+        let span = entries[entry].span
+        let base = items[index].payload.lowerBound
+        return String(decoding: bytes[base + span.offset..<base + span.end], as: UTF8.self)
+    }
+
+    /// Value of the top level object `tag` of item `index`
+    func value(of tag: UInt8, inItem index: Int) -> String? {
+        entryIndex(of: tag, inItem: index).map { value(atEntry: $0, inItem: index) }
+    }
+
+    func payload(at index: Int) -> String {
+        String(decoding: bytes[items[index].payload], as: UTF8.self)
+    }
+
+    /// Stage 2 for one item: the SDK object graph, allocated outside the arena.
+    /// An item without `error` has only passed the header scan and the CRC trailer check, so the payload gets
+    /// the full `parse(string:)` validation here, and throws what the default `parseBatch(strings:)` would.
+    func pushPaymentData(at index: Int) throws -> PushPaymentData {
+        if let error = items[index].error {
+            throw error
+        }
+        return try MPQRParser.parse(string: payload(at: index))
+    }
+}
+
+extension MPQRParser {
+    /// Scans `strings` into `arena`, which is reset first.
+    /// Unlike `parseBatch(strings:parse:)` no SDK object is built and the strings are scanned serially;
+    /// results are read from the arena's tapes. Tag formats and mandatory tags are not checked until `pushPaymentData(at:)`.
+    static func parseBatch(strings: [String], into arena: EMVQRBatchArena, validatesCRC: Bool = true) -> EMVQRBatchStatistics {
+        let start = DispatchTime.now().uptimeNanoseconds
+        arena.reset()
+        arena.reserveCapacity(strings.count, payloadBytes: strings.reduce(0) { $0 + $1.utf8.count })
+        var failures = 0
+        for string in strings {
+            if arena.append(string, validatesCRC: validatesCRC).error != nil {
+                failures += 1
+            }
+        }
+        let elapsed = TimeInterval(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000
+        return EMVQRBatchStatistics(count: strings.count, failures: failures, bytes: arena.bytes.count, elapsed: elapsed)
+    }
+}
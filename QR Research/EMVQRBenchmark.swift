@@ -0,0 +1,322 @@
+//
+//  EMVQRBenchmark.swift
+//  QR Research
+//
+
+#if DEBUG
+import Foundation
+import MPQRCoreSDK
+
+/// Debug only benchmarks of MPQRCoreSDK and the EMV QR helpers.
+/// Call from the debugger or a scratch action, e.g. `EMVQRBenchmark.report()`.
+enum EMVQRBenchmark {
+    struct Measurement: CustomStringConvertible {
+        let name: String
+        /// Per operation timings in nanoseconds, sorted
+        let samples: [UInt64]
+        /// `malloc`, `calloc` and `realloc` calls per operation, freed or not, counted by `EMVQRAllocationCounter`
+        let allocationsPerOperation: Double
+
+        var iterations: Int {
+            samples.count
+        }
+
+        var nanosecondsPerOperation: Double {
+            Double(samples.reduce(0, +)) / Double(max(1, samples.count))
+        }
+
+        func percentile(_ percent: Double) -> UInt64 {
+            guard !samples.isEmpty else {
+                return 0
+            }
+            let index = min(samples.count - 1, Int(Double(samples.count) * percent / 100))
+            return samples[index]
+        }
+
+        var description: String {
+            String(format: "%@: %.1f ns/op p50 %llu p90 %llu p99 %llu, %.2f allocs/op (%d ops)",
+                   name, nanosecondsPerOperation, percentile(50), percentile(90), percentile(99),
+                   allocationsPerOperation, iterations)
+        }
+    }
+
+    /// Heap held by the results of one batch, and the time to build and to release them
+    struct PressureMeasurement: CustomStringConvertible {
+        let name: String
+        let count: Int
+        let blocks: Int
+        let bytes: Int
+        let parseNanoseconds: UInt64
+        let releaseNanoseconds: UInt64
+
+        var description: String {
+            String(format: "%@: %.2f blocks/item %.0f B/item live, parse %.1f ms, release %.3f ms (%d items)",
+                   name, Double(blocks) / Double(max(1, count)), Double(bytes) / Double(max(1, count)),
+                   Double(parseNanoseconds) / 1e6, Double(releaseNanoseconds) / 1e6, count)
+        }
+    }
+
+    static func measurePressure<Results>(_ name: String, count: Int, _ parse: () -> Results) -> PressureMeasurement {
+        let before = liveHeap()
+        let start = DispatchTime.now().uptimeNanoseconds
+        var results: Results? = parse()
+        let parsed = DispatchTime.now().uptimeNanoseconds
+        // Keep the results alive until the heap is read, so the optimizer cannot free them early
+        let (after, releasing) = withExtendedLifetime(results) { (liveHeap(), DispatchTime.now().uptimeNanoseconds) }
+        results = nil
+        let released = DispatchTime.now().uptimeNanoseconds
+        return PressureMeasurement(name: name, count: count,
+                                   blocks: Int(after.blocks_in_use) - Int(before.blocks_in_use),
+                                   bytes: Int(after.size_in_use) - Int(before.size_in_use),
+                                   parseNanoseconds: parsed - start, releaseNanoseconds: released - releasing)
+    }
+
+    static func measure(_ name: String, iterations: Int, _ body: () -> Void) -> Measurement {
+        body()
+        var samples = [UInt64](repeating: 0, count: iterations)
+        for index in 0..<iterations {
+            let start = DispatchTime.now().uptimeNanoseconds
+            body()
+            samples[index] = DispatchTime.now().uptimeNanoseconds - start
+        }
+        samples.sort()
+
+        // Counted in a separate pass so the zone hooks do not skew the timings
+        let counted = min(iterations, 100)
+        let allocations = EMVQRAllocationCounter.count {
+            for _ in 0..<counted {
+                body()
+            }
+        }
+        return Measurement(name: name, samples: samples,
+                           allocationsPerOperation: Double(allocations) / Double(max(1, counted)))
+    }
+
+    private static func liveHeap() -> malloc_statistics_t {
+        var statistics = malloc_statistics_t()
+        malloc_zone_statistics(nil, &statistics)
+        return statistics
+    }
+
+    static func report(iterations: Int = 2_000) {
+        (suite(iterations: iterations) + crc16(iterations: iterations) + rejection(iterations: iterations)).forEach { print($0) }
+        allocatorPressure().forEach { print($0) }
+    }
+
+    /// Parse, generate and checksum entry points over `EMVQRCorpus`
+    static func suite(iterations: Int = 2_000) -> [Measurement] {
+        let corpus = EMVQRCorpus.generate(count: 240)
+        let generated = corpus.compactMap { try? MPQRParser.parseWithoutTagValidationAndCRC($0) }
+        var cursor = 0
+        func next() -> String {
+            cursor = (cursor + 1) % corpus.count
+            return corpus[cursor]
+        }
+
+        var measurements: [Measurement] = []
+        measurements.append(measure("MPQRParser.parse", iterations: iterations) {
+            _ = try? MPQRParser.parse(string: next())
+        })
+        measurements.append(measure("MPQRParser.parseWithValidationWarnings", iterations: iterations) {
+            _ = try? MPQRParser.parseWithValidationWarnings(string: next())
+        })
+        measurements.append(measure("MPQRParser.parseWithoutTagValidation", iterations: iterations) {
+            _ = try? MPQRParser.parseWithoutTagValidation(next())
+        })
+        measurements.append(measure("MPQRParser.parseWithoutTagValidationAndCRC", iterations: iterations) {
+            _ = try? MPQRParser.parseWithoutTagValidationAndCRC(next())
+        })
+        measurements.append(measure("MPQRParser.parseLazily", iterations: iterations) {
+            _ = try? MPQRParser.parseLazily(string: next())
+        })
+        measurements.append(measure("PushPaymentData.generatePushPaymentString", iterations: iterations) {
+            cursor = (cursor + 1) % generated.count
+            _ = try? generated[cursor].generatePushPaymentString()
+        })
+        measurements.append(measure("ChecksumUtility.isValidCrc16", iterations: iterations) {
+            _ = ChecksumUtility.isValidCrc16(next())
+        })
+        measurements.append(measure("ChecksumUtility.isValidCrc16(bytes:)", iterations: iterations) {
+            _ = ChecksumUtility.isValidCrc16(bytes: Array(next().utf8))
+        })
+        measurements.append(measure("ChecksumUtility.validateLuhnChecksum", iterations: iterations) {
+            _ = ChecksumUtility.validateLuhnChecksum("5555555555554444")
+        })
+        verifyLuhn()
+        measurements.append(measure("ChecksumUtility.validateLuhnChecksums", iterations: iterations) {
+            _ = ChecksumUtility.validateLuhnChecksums(["5555555555554444"])
+        })
+        return measurements
+    }
+
+    /// Checks `EMVQRLuhn` against `ChecksumUtility.validateLuhnChecksum(_:)` on random digit strings of
+    /// 1 to 40 digits, so single blocks, partial blocks and several blocks are covered, one by one and packed.
+    static func verifyLuhn() {
+        var generator = SystemRandomNumberGenerator()
+        for width in 1...40 {
+            let identifiers = (0..<50).map { _ in
+                String((0..<width).map { _ in Character(String(Int.random(in: 0...9, using: &generator))) })
+            }
+            let expected = identifiers.map { ChecksumUtility.validateLuhnChecksum($0) }
+            precondition(ChecksumUtility.validateLuhnChecksums(identifiers) == expected,
+                         "EMVQRLuhn disagrees with ChecksumUtility.validateLuhnChecksum on \(width) digits")
+            precondition(ChecksumUtility.validateLuhnChecksums(packed: Array(identifiers.joined().utf8), width: width) == expected,
+                         "Packed EMVQRLuhn disagrees with ChecksumUtility.validateLuhnChecksum on \(width) digits")
+        }
+    }
+
+    /// `ChecksumUtility.crc16(_:)` against `EMVQRCRC16` on 64 to 512 byte payloads.
+    /// Both are first checked to agree, see `verifyCRC16()`.
+    static func crc16(iterations: Int = 10_000) -> [Measurement] {
+        verifyCRC16()
+        var measurements: [Measurement] = []
+        for size in [64, 128, 256, 512] {
+            let bytes = (0..<size).map { UInt8(0x30 + $0 % 10) }
+            let string = String(decoding: bytes, as: UTF8.self)
+            precondition(ChecksumUtility.crc16(string) == EMVQRCRC16.hexString(EMVQRCRC16.checksum(bytes)),
+                         "EMVQRCRC16 disagrees with ChecksumUtility.crc16 on the \(size) byte input")
+            var sink: UInt16 = 0
+
+            measurements.append(measure("ChecksumUtility.crc16 \(size)B", iterations: iterations) {
+                sink ^= UInt16(ChecksumUtility.crc16(string).utf8.count)
+            })
+            measurements.append(measure("EMVQRCRC16 \(size)B", iterations: iterations) {
+                sink ^= EMVQRCRC16.checksum(bytes)
+            })
+            _ = sink
+        }
+        return measurements
+    }
+
+    /// Checks `EMVQRCRC16` against `ChecksumUtility.crc16(_:)` on every length from 0 to 520 bytes,
+    /// so each tail length of the 8 byte slicing loop is covered, and checks that a checkpoint resumed
+    /// over a suffix gives the same CRC as hashing the whole payload.
+    static func verifyCRC16() {
+        let alphabet = Array("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz.-".utf8)
+        var generator = SystemRandomNumberGenerator()
+        for length in 0...520 {
+            let bytes = (0..<length).map { _ in alphabet.randomElement(using: &generator)! }
+            let string = String(decoding: bytes, as: UTF8.self)
+            precondition(ChecksumUtility.crc16(string) == ChecksumUtility.crc16(bytes: bytes),
+                         "EMVQRCRC16 disagrees with ChecksumUtility.crc16 on \(string)")
+
+            let split = length / 3
+            let checkpoint = ChecksumUtility.crc16Checkpoint(prefix: Array(bytes[..<split]))
+            let suffix = Array(bytes[split...])
+            precondition(ChecksumUtility.crc16(resuming: checkpoint, suffix: suffix)
+                            == ChecksumUtility.crc16(string + String(decoding: EMVQRCRC16.trailer, as: UTF8.self)),
+                         "Resumed EMVQRCRC16 disagrees with ChecksumUtility.crc16 on \(string)")
+        }
+    }
+
+    /// Cost of rejecting corrupted scans: every payload of `EMVQRCorpus` with one character changed,
+    /// as a camera misread would, so each fails its CRC
+    static func rejection(iterations: Int = 2_000) -> [Measurement] {
+        let corrupted = EMVQRCorpus.generate(count: 240).map { payload -> String in
+            var bytes = Array(payload.utf8)
+            let index = bytes.count / 2
+            bytes[index] = bytes[index] == 0x41 ? 0x42 : 0x41
+            return String(decoding: bytes, as: UTF8.self)
+        }
+        var cursor = 0
+        func next() -> String {
+            cursor = (cursor + 1) % corrupted.count
+            return corrupted[cursor]
+        }
+
+        var measurements: [Measurement] = []
+        measurements.append(measure("Rejection MPQRParser.parse", iterations: iterations) {
+            _ = try? MPQRParser.parse(string: next())
+        })
+        measurements.append(measure("Rejection MPQRParser.parseWithoutTagValidation", iterations: iterations) {
+            _ = try? MPQRParser.parseWithoutTagValidation(next())
+        })
+        measurements.append(measure("Rejection MPQRParser.parseFailFast", iterations: iterations) {
+            _ = try? MPQRParser.parseFailFast(string: next())
+        })
+        measurements.append(measure("Rejection MPQRParser.parseLazily", iterations: iterations) {
+            _ = try? MPQRParser.parseLazily(string: next())
+        })
+        return measurements
+    }
+
+    /// Heap held by a reconciliation sized batch: SDK objects, lazily parsed payloads, and one `EMVQRBatchArena`.
+    /// All three run serially on the calling thread, so parse times compare the parsers, not the core count.
+    /// None of them validates tag formats: the SDK baseline skips tag validation, as the arena and the lazy
+    /// parser defer it, so the figures compare structure and CRC checks only.
+    static func allocatorPressure(count: Int = 100_000) -> [PressureMeasurement] {
+        let corpus = EMVQRCorpus.generate(count: count)
+        return [
+            measurePressure("MPQRParser.parseWithoutTagValidation", count: count) {
+                corpus.map { try? MPQRParser.parseWithoutTagValidation($0) }
+            },
+            measurePressure("MPQRParser.parseLazily", count: count) {
+                corpus.map { try? MPQRParser.parseLazily(string: $0) }
+            },
+            measurePressure("MPQRParser.parseBatch(into: EMVQRBatchArena), scan and CRC", count: count) { () -> EMVQRBatchArena in
+                let arena = EMVQRBatchArena()
+                _ = MPQRParser.parseBatch(strings: corpus, into: arena)
+                return arena
+            },
+        ]
+    }
+}
+
+/// Counts the heap allocations of the calling thread by swapping the `malloc`, `calloc` and `realloc`
+/// entry points of the default malloc zone while `count(_:)` runs.
+/// Allocations that bypass the default zone, such as `mmap` or a custom zone, are not seen.
+private enum EMVQRAllocationCounter {
+    /// Number of allocations made by the calling thread during `body`
+    static func count(_ body: () -> Void) -> Int {
+        guard let zone = malloc_default_zone() else {
+            return 0
+        }
+        // Touch the globals first: the hooks must not run their lazy initialisation from inside malloc
+        allocationCount = 0
+        countingThread = pthread_self()
+        originalZone = zone.pointee
+
+        setWritable(zone, true)
+        zone.pointee.malloc = { zone, size in
+            recordAllocation()
+            return originalZone.malloc(zone, size)
+        }
+        zone.pointee.calloc = { zone, count, size in
+            recordAllocation()
+            return originalZone.calloc(zone, count, size)
+        }
+        zone.pointee.realloc = { zone, pointer, size in
+            recordAllocation()
+            return originalZone.realloc(zone, pointer, size)
+        }
+        setWritable(zone, false)
+
+        body()
+
+        setWritable(zone, true)
+        zone.pointee.malloc = originalZone.malloc
+        zone.pointee.calloc = originalZone.calloc
+        zone.pointee.realloc = originalZone.realloc
+        setWritable(zone, false)
+        countingThread = nil
+        return allocationCount
+    }
+
+    /// The default zone is read-only outside its setup
+    private static func setWritable(_ zone: UnsafeMutablePointer<malloc_zone_t>, _ writable: Bool) {
+        vm_protect(mach_task_self_, vm_address_t(UInt(bitPattern: zone)), vm_size_t(MemoryLayout<malloc_zone_t>.size),
+                   0, writable ? VM_PROT_READ | VM_PROT_WRITE : VM_PROT_READ)
+    }
+}
+
+// State of the zone hooks. They are C function pointers and cannot capture, hence globals.
+private var allocationCount = 0
+private var countingThread: pthread_t?
+private var originalZone = malloc_zone_t()
+
+private func recordAllocation() {
+    if let thread = countingThread, pthread_equal(thread, pthread_self()) != 0 {
+        allocationCount += 1
+    }
+}
+#endif
@@ -0,0 +1,220 @@
+//
+//  EMVQRCRC16.swift
+//  QR Research
+//
+
+import Foundation
+
+/// CRC16 as required by EMVCo (ISO/IEC 3309, CRC-CCITT: polynomial 0x1021, initial value 0xFFFF).
+/// Table driven, consuming 8 bytes per step (slicing-by-8), and incremental:
+/// `update` can be called any number of times before reading `value`.
+/// Being a value type, a copy taken after a fixed prefix is a checkpoint that can be resumed over many suffixes.
+struct EMVQRCRC16 {
+    static let polynomial: UInt16 = 0x1021
+    static let initialValue: UInt16 = 0xFFFF
+    /// Tag and length of the CRC object, hashed last before the CRC itself
+    static let trailer: [UInt8] = Array("6304".utf8)
+
+    /// `tables[k * 256 + b]` is the CRC of byte `b` followed by `k` zero bytes, starting from 0
+    static let tables: [UInt16] = {
+        var tables = [UInt16](repeating: 0, count: 8 * 256)
+        for byte in 0..<256 {
+            var crc = UInt16(byte) << 8
+            for _ in 0..<8 {
+                crc = crc & 0x8000 != 0 ? (crc << 1) ^ EMVQRCRC16.polynomial : crc << 1
+            }
+            tables[byte] = crc
+        }
+        for slice in 1..<8 {
+            for byte in 0..<256 {
+                let previous = tables[(slice - 1) * 256 + byte]
+                tables[slice * 256 + byte] = (previous << 8) ^ tables[Int(previous >> 8)]
+            }
+        }
+        return tables
+    }()
+
+    private(set) var value: UInt16 = EMVQRCRC16.initialValue
+
+    init() {}
+
+    /// Resumes from a state saved from `value`, e.g. stored alongside a payload prefix
+    init(resumingFrom value: UInt16) {
+        self.value = value
+    }
+
+    /// CRC in the 4 digit upper case hex format used by tag 63
+    var hexString: String {
+        EMVQRCRC16.hexString(value)
+    }
+
+    mutating func update<Bytes: ContiguousBytes>(_ bytes: Bytes) {
+        bytes.withUnsafeBytes { update(buffer: $0) }
+    }
+
+    mutating func update(_ string: String) {
+        var string = string
+        string.withUTF8 { update(buffer: UnsafeRawBufferPointer($0)) }
+    }
+
+    mutating func update(buffer: UnsafeRawBufferPointer) {
+        guard !buffer.isEmpty else {
+            return
+        }
+        var crc = value
+        EMVQRCRC16.tables.withUnsafeBufferPointer { table in
+            var index = 0
+            let count = buffer.count
+            while count - index >= 8 {
+                let high = buffer[index] ^ UInt8(crc >> 8)
+                let low = buffer[index + 1] ^ UInt8(truncatingIfNeeded: crc)
+                crc = table[7 * 256 + Int(high)]
+                    ^ table[6 * 256 + Int(low)]
+                    ^ table[5 * 256 + Int(buffer[index + 2])]
+                    ^ table[4 * 256 + Int(buffer[index + 3])]
+                    ^ table[3 * 256 + Int(buffer[index + 4])]
+                    ^ table[2 * 256 + Int(buffer[index + 5])]
+                    ^ table[1 * 256 + Int(buffer[index + 6])]
+                    ^ table[Int(buffer[index + 7])]
+                index += 8
+            }
+            while index < count {
+                crc = (crc << 8) ^ table[Int(UInt8(crc >> 8) ^ buffer[index])]
+                index += 1
+            }
+        }
+        value = crc
+    }
+
+    // MARK: - Checkpoints
+
+    /// CRC of the hashed bytes followed by the `6304` trailer. The receiver is left unchanged.
+    func finalized() -> UInt16 {
+        var crc = self
+        crc.update(EMVQRCRC16.trailer)
+        return crc.value
+    }
+
+    /// CRC of the hashed bytes, then `suffix`, then the `6304` trailer. The receiver is left unchanged.
+    func finalized(appending suffix: UnsafeRawBufferPointer) -> UInt16 {
+        var crc = self
+        crc.update(buffer: suffix)
+        return crc.finalized()
+    }
+
+    func finalized<Bytes: ContiguousBytes>(appending suffix: Bytes) -> UInt16 {
+        suffix.withUnsafeBytes { finalized(appending: $0) }
+    }
+
+    // MARK: - One shot helpers
+
+    static func checksum<Bytes: ContiguousBytes>(_ bytes: Bytes) -> UInt16 {
+        var crc = EMVQRCRC16()
+        crc.update(bytes)
+        return crc.value
+    }
+
+    static func hexString(_ value: UInt16) -> String {
+        let digits: [UInt8] = Array("0123456789ABCDEF".utf8)
+        let bytes = [
+            digits[Int(value >> 12)],
+            digits[Int(value >> 8 & 0xF)],
+            digits[Int(value >> 4 & 0xF)],
+            digits[Int(value & 0xF)],
+        ]
+        return String(decoding: bytes, as: UTF8.self)
+    }
+
+    /// Parses 4 hex digits, either case
+    static func parseHex(_ bytes: UnsafeRawBufferPointer) -> UInt16? {
+        guard bytes.count == 4 else {
+            return nil
+        }
+        var value: UInt16 = 0
+        for byte in bytes {
+            let nibble: UInt8
+            switch byte {
+            case 0x30...0x39:
+                nibble = byte - 0x30
+            case 0x41...0x46:
+                nibble = byte - 0x41 + 10
+            case 0x61...0x66:
+                nibble = byte - 0x61 + 10
+            default:
+                return nil
+            }
+            value = value << 4 | UInt16(nibble)
+        }
+        return value
+    }
+
+    /// Checks the trailing 4 hex digits of `payload` against the CRC of everything before them
+    static func isValid(payload: UnsafeRawBufferPointer) -> Bool {
+        guard payload.count >= 4,
+              let expected = parseHex(UnsafeRawBufferPointer(rebasing: payload[(payload.count - 4)...])) else {
+            return false
+        }
+        var crc = EMVQRCRC16()
+        crc.update(buffer: UnsafeRawBufferPointer(rebasing: payload[..<(payload.count - 4)]))
+        return crc.value == expected
+    }
+
+    /// Checks that `payload` ends in a `6304` object holding the CRC of everything before it.
+    /// Only the trailer and one CRC pass are read, so garbage input is rejected before any tokenising.
+    /// - Note: Throws `EMVQRError.missingTag` without a `6304` trailer, `.invalidTagValue` for a wrong CRC
+    static func validateTrailer(of payload: UnsafeRawBufferPointer) throws {
+        let crcTag = EMVQRPayload.Tags.crc
+        let headerOffset = payload.count - 8
+        guard headerOffset >= 0,
+              UnsafeRawBufferPointer(rebasing: payload[headerOffset..<headerOffset + 4]).elementsEqual(trailer) else {
+            throw EMVQRError.missingTag(tag: crcTag)
+        }
+        guard isValid(payload: payload) else {
+            throw EMVQRError.invalidTagValue(tag: crcTag, offset: headerOffset + 4, length: 4)
+        }
+    }
+
+    /// `validateTrailer(of:)` on the UTF-8 of `string`, borrowed in place when the string has contiguous UTF-8.
+    /// A bridged `NSString` without it is streamed through a small stack buffer instead of being copied whole.
+    static func validateTrailer(of string: String) throws {
+        let borrowed: Void? = try string.utf8.withContiguousStorageIfAvailable {
+            try validateTrailer(of: UnsafeRawBufferPointer($0))
+        }
+        if borrowed != nil {
+            return
+        }
+
+        var crc = EMVQRCRC16()
+        // Last 8 bytes read, the newest in the low byte
+        var tail: UInt64 = 0
+        var count = 0
+        withUnsafeTemporaryAllocation(of: UInt8.self, capacity: 64) { chunk in
+            var filled = 0
+            for byte in string.utf8 {
+                // Once a byte has 4 successors it cannot be one of the CRC digits, so it is hashed
+                if count >= 4 {
+                    chunk[filled] = UInt8(truncatingIfNeeded: tail >> 24)
+                    filled += 1
+                    if filled == chunk.count {
+                        crc.update(buffer: UnsafeRawBufferPointer(chunk))
+                        filled = 0
+                    }
+                }
+                tail = tail << 8 | UInt64(byte)
+                count += 1
+            }
+            crc.update(buffer: UnsafeRawBufferPointer(UnsafeMutableBufferPointer(rebasing: chunk[..<filled])))
+        }
+
+        let crcTag = EMVQRPayload.Tags.crc
+        let header = UInt32(truncatingIfNeeded: tail >> 32)
+        let expectedHeader = trailer.reduce(UInt32(0)) { $0 << 8 | UInt32($1) }
+        guard count >= 8, header == expectedHeader else {
+            throw EMVQRError.missingTag(tag: crcTag)
+        }
+        let digits = withUnsafeBytes(of: UInt32(truncatingIfNeeded: tail).bigEndian) { parseHex($0) }
+        guard digits == crc.value else {
+            throw EMVQRError.invalidTagValue(tag: crcTag, offset: count - 4, length: 4)
+        }
+    }
+}
@@ -0,0 +1,78 @@
+//
+//  EMVQRCharacterClass.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Character class checks over whole value spans, 16 bytes per step with `SIMD16<UInt8>`.
+/// The tail block is padded with a byte that belongs to the class being checked.
+enum EMVQRCharacterClass {
+    private static let digitZero = SIMD16<UInt8>(repeating: 0x30)
+    private static let ten = SIMD16<UInt8>(repeating: 10)
+    private static let space = SIMD16<UInt8>(repeating: 0x20)
+    /// 0x20...0x7E
+    private static let printableCount = SIMD16<UInt8>(repeating: 0x5F)
+    private static let dot = SIMD16<UInt8>(repeating: 0x2E)
+    private static let continuationMask = SIMD16<UInt8>(repeating: 0xC0)
+    private static let continuation = SIMD16<UInt8>(repeating: 0x80)
+    private static let one = SIMD16<UInt8>(repeating: 1)
+
+    /// All bytes are ASCII digits
+    static func isNumeric(_ bytes: UnsafeRawBufferPointer) -> Bool {
+        allBlocks(bytes, padding: 0x30) { !any(($0 &- digitZero) .>= ten) }
+    }
+
+    /// All bytes are printable ASCII (ANS)
+    static func isAlphanumericSpecial(_ bytes: UnsafeRawBufferPointer) -> Bool {
+        allBlocks(bytes, padding: 0x20) { !any(($0 &- space) .>= printableCount) }
+    }
+
+    /// Digits with at most one `.` and at least one digit
+    static func isAmount(_ bytes: UnsafeRawBufferPointer) -> Bool {
+        var dots = 0
+        let isValid = allBlocks(bytes, padding: 0x30) { block in
+            let isDot = block .== dot
+            guard !any(((block &- digitZero) .>= ten) .& .!isDot) else {
+                return false
+            }
+            dots += Int(SIMD16<UInt8>().replacing(with: one, where: isDot).wrappingSum())
+            return dots <= 1
+        }
+        return isValid && bytes.count > dots
+    }
+
+    /// Number of UTF-8 encoded characters, i.e. bytes that are not continuation bytes
+    static func characterCount(_ bytes: UnsafeRawBufferPointer) -> Int {
+        var continuations = 0
+        _ = allBlocks(bytes, padding: 0x20) { block in
+            let isContinuation = (block & continuationMask) .== continuation
+            continuations += Int(SIMD16<UInt8>().replacing(with: one, where: isContinuation).wrappingSum())
+            return true
+        }
+        return bytes.count - continuations
+    }
+
+    /// Calls `body` for each block of 16 bytes until it returns `false`
+    private static func allBlocks(_ bytes: UnsafeRawBufferPointer, padding: UInt8,
+                                  _ body: (SIMD16<UInt8>) -> Bool) -> Bool {
+        guard let base = bytes.baseAddress else {
+            return true
+        }
+        var offset = 0
+        while bytes.count - offset >= 16 {
+            guard body((base + offset).loadUnaligned(as: SIMD16<UInt8>.self)) else {
+                return false
+            }
+            offset += 16
+        }
+        guard offset < bytes.count else {
+            return true
+        }
+        var tail = SIMD16<UInt8>(repeating: padding)
+        for index in offset..<bytes.count {
+            tail[index - offset] = bytes[index]
+        }
+        return body(tail)
+    }
+}
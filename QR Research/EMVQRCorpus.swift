@@ -0,0 +1,89 @@
+//
+//  EMVQRCorpus.swift
+//  QR Research
+//
+
+#if DEBUG
+import Foundation
+
+/// Generated payloads for `EMVQRBenchmark`, covering the shapes seen in the field:
+/// static and dynamic, Mastercard tag 05, several merchant accounts, alternate language and unreserved templates.
+enum EMVQRCorpus {
+    enum Kind: CaseIterable {
+        case staticMerchant
+        case dynamicMerchant
+        case masterCard
+        case multipleAccounts
+        case language
+        case unreserved
+    }
+
+    static let merchantNames = ["Cham Roeun DUCH", "Brown Coffee", "Lucky Mart", "Sorya Mall", "Angkor Book"]
+    static let billNumbers = ["INV-0001", "INV-1024", "A12345", "20230117-77"]
+
+    /// `count` payloads cycling through every `Kind`, each with a valid CRC
+    static func generate(count: Int) -> [String] {
+        (0..<count).map { index in
+            let kinds = Kind.allCases
+            return payload(kinds[index % kinds.count], variant: index / kinds.count)
+        }
+    }
+
+    static func payload(_ kind: Kind, variant: Int = 0) -> String {
+        let name = merchantNames[variant % merchantNames.count]
+        let amount = String(format: "%d.%02d", 1 + variant % 500, variant % 100)
+        let billNumber = billNumbers[variant % billNumbers.count]
+        let aba = template(("00", "abaakhppxxx@abaa"), ("01", "000287811"), ("02", "ABA Bank"))
+
+        var fields: [(String, String)] = [("00", EMVQRConstants.payloadFormatIndicator)]
+        switch kind {
+        case .staticMerchant:
+            fields += [("01", EMVQRConstants.pointOfInitiationMethodStatic), ("30", aba)]
+        case .dynamicMerchant:
+            fields += [("01", EMVQRConstants.pointOfInitiationMethodDynamic), ("30", aba)]
+        case .masterCard:
+            fields += [("01", EMVQRConstants.pointOfInitiationMethodStatic),
+                       ("04", "5555555555554444"),
+                       ("05", template(("01", "MERCHANTALIAS\(variant % 10)"), ("02", "MAID0001")))]
+        case .multipleAccounts:
+            fields += [("01", EMVQRConstants.pointOfInitiationMethodStatic),
+                       ("26", template(("00", "A000000677010112"), ("01", "010552300935"))),
+                       ("29", template(("00", "khqr@bakong"), ("01", "merchant\(variant % 100)@bank"))),
+                       ("30", aba)]
+        case .language:
+            fields += [("01", EMVQRConstants.pointOfInitiationMethodStatic), ("30", aba)]
+        case .unreserved:
+            fields += [("01", EMVQRConstants.pointOfInitiationMethodStatic), ("30", aba)]
+        }
+
+        fields += [("52", EMVQRConstants.merchantCategoryDefaultCode), ("53", kind == .dynamicMerchant ? "840" : "116")]
+        if kind == .dynamicMerchant {
+            fields.append(("54", amount))
+        }
+        fields += [("58", EMVQRConstants.countryCode), ("59", name), ("60", EMVQRConstants.merchantDefaultCity)]
+        if kind == .dynamicMerchant {
+            fields.append(("62", template(("01", billNumber), ("08", "Coffee"))))
+        }
+        if kind == .language {
+            fields.append(("64", template(("00", "KM"), ("01", "ហាងកាហ្វេ"), ("02", "ភ្នំពេញ"))))
+        }
+        if kind == .unreserved {
+            fields.append(("80", template(("00", "A0000006770101"), ("01", "loyalty-\(variant % 1000)"))))
+        }
+
+        let body = fields.map { tlv($0.0, $0.1) }.joined() + "6304"
+        var crc = EMVQRCRC16()
+        crc.update(body)
+        return body + crc.hexString
+    }
+
+    static func tlv(_ tag: String, _ value: String) -> String {
+        let length = value.unicodeScalars.count
+        return tag + (length < 10 ? "0\(length)" : "\(length)") + value
+    }
+
+    static func template(_ fields: (String, String)...) -> String {
+        fields.map { tlv($0.0, $0.1) }.joined()
+    }
+}
+#endif
@@ -0,0 +1,49 @@
+//
+//  EMVQRData.swift
+//  QR Research
+//
+
+import Foundation
+
+/// One scanned template: the payload bytes plus the spans of its TLV objects.
+/// Plays the role of `AbstractData`, but values are only turned into strings when read.
+struct EMVQRData {
+    let bytes: [UInt8]
+    let store: EMVQRTagStore
+
+    /// Scans `range` of `bytes`
+    /// - Parameter rootTag: Top level template `range` holds, reported in errors
+    /// - Note: Throws `EMVQRError.invalidFormat` or `EMVQRError.duplicateTag`
+    init(bytes: [UInt8], range: Range<Int>? = nil, rootTag: UInt8? = nil) throws {
+        var scanner = EMVQRScanner(bytes: bytes, range: range)
+        var store = EMVQRTagStore()
+        while let span = try scanner.next() {
+            guard store.insert(span) else {
+                throw EMVQRError.duplicateTag(tag: span.tag, offset: span.headerOffset, rootTag: rootTag)
+            }
+        }
+        self.bytes = bytes
+        self.store = store
+    }
+
+    var count: Int {
+        store.count
+    }
+
+    func hasValue(for tag: UInt8) -> Bool {
+        store.contains(tag)
+    }
+
+    func span(for tag: UInt8) -> EMVQRSpan? {
+        store[tag]
+    }
+
+    func value(for tag: UInt8) -> String? {
+        store[tag].map { String(decoding: bytes[$0.offset..<$0.end], as: UTF8.self) }
+    }
+
+    /// Compares the value of `tag` with `string` without building a `String`
+    func value(for tag: UInt8, equals string: String) -> Bool {
+        store[tag].map { EMVQRValidator.equals(bytes, $0, string) } ?? false
+    }
+}
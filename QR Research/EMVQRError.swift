@@ -0,0 +1,146 @@
+//
+//  EMVQRError.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Errors raised by the byte level EMV QR helpers.
+/// Offsets index the UTF-8 bytes of the scanned payload.
+/// `rootTag` is the top level template (05, 26...51, 62, 64, 80...99) holding the offending tag, `nil` at the top level.
+/// An error is just a code, a tag, a root tag and a value span; message, `TagInfo` and value are only built
+/// when `errorUserInfo` or `value(in:)` is read, which keeps rejecting hostile input cheap.
+enum EMVQRError: Error, Equatable {
+    /// Tag or length header is not two ASCII digits, or the value runs past the end of the payload
+    case invalidFormat(offset: Int)
+    /// Value does not match the format of its tag, including a wrong CRC
+    case invalidTagValue(tag: UInt8, offset: Int, length: Int = 0, rootTag: UInt8? = nil)
+    /// Mandatory tag is not present
+    case missingTag(tag: UInt8, rootTag: UInt8? = nil)
+    /// Tag is present while another tag forbids it
+    case conflictingTag(tag: UInt8, rootTag: UInt8? = nil)
+    /// Tag appears twice in the same template
+    case duplicateTag(tag: UInt8, offset: Int, rootTag: UInt8? = nil)
+    /// Tag is reserved for future use
+    case rfuTag(tag: UInt8, offset: Int, rootTag: UInt8? = nil)
+
+    /// Raw value of the matching `MPQRErrorCode`
+    var code: Int {
+        switch self {
+        case .invalidFormat:
+            return 0
+        case .invalidTagValue:
+            return 1
+        case .missingTag:
+            return 3
+        case .conflictingTag:
+            return 4
+        case .rfuTag:
+            return 5
+        case .duplicateTag:
+            return 6
+        }
+    }
+
+    var tag: UInt8? {
+        switch self {
+        case .invalidFormat:
+            return nil
+        case .invalidTagValue(let tag, _, _, _), .missingTag(let tag, _), .conflictingTag(let tag, _),
+             .duplicateTag(let tag, _, _), .rfuTag(let tag, _, _):
+            return tag
+        }
+    }
+
+    var rootTag: UInt8? {
+        switch self {
+        case .invalidFormat:
+            return nil
+        case .invalidTagValue(_, _, _, let rootTag), .missingTag(_, let rootTag), .conflictingTag(_, let rootTag),
+             .duplicateTag(_, _, let rootTag), .rfuTag(_, _, let rootTag):
+            return rootTag
+        }
+    }
+
+    /// `TagInfo` of `tag`, from the table of the template named by `rootTag`
+    var tagInfo: TagInfo? {
+        guard let tag = tag else {
+            return nil
+        }
+        return EMVQRTagTable.table(nestedIn: rootTag)?[tag]
+    }
+
+    var message: String {
+        let location = rootTag.map { " in template \(EMVQRBytes.tagString($0))" } ?? ""
+        switch self {
+        case .invalidFormat(let offset):
+            return "Invalid format at offset \(offset)"
+        case .invalidTagValue(let tag, let offset, _, _):
+            return "Invalid value for tag \(EMVQRBytes.tagString(tag))\(location) at offset \(offset)"
+        case .missingTag(let tag, _):
+            return "Missing tag \(EMVQRBytes.tagString(tag))\(location)"
+        case .conflictingTag(let tag, _):
+            return "Conflicting tag \(EMVQRBytes.tagString(tag))\(location)"
+        case .duplicateTag(let tag, let offset, _):
+            return "Duplicate tag \(EMVQRBytes.tagString(tag))\(location) at offset \(offset)"
+        case .rfuTag(let tag, let offset, _):
+            return "Reserved tag \(EMVQRBytes.tagString(tag))\(location) at offset \(offset)"
+        }
+    }
+
+    /// Span of the offending value, if the error refers to one
+    var valueSpan: EMVQRSpan? {
+        guard case .invalidTagValue(let tag, let offset, let length, _) = self, length > 0 else {
+            return nil
+        }
+        return EMVQRSpan(tag: tag, offset: offset, length: length)
+    }
+
+    /// Offending value, read from the payload the error was raised for
+    func value(in payload: [UInt8]) -> String? {
+        guard let span = valueSpan, span.end <= payload.count else {
+            return nil
+        }
+        return String(decoding: payload[span.offset..<span.end], as: UTF8.self)
+    }
+
+    /// Builds the equivalent `MPQRError`, e.g. to fill `PushPaymentData.validationErrors`
+    /// - Parameter payload: Payload the error was raised for; when given, the offending value is added to `userInfo`
+    func mpqrError(payload: [UInt8]? = nil) -> MPQRError {
+        var userInfo = errorUserInfo
+        if let value = payload.flatMap({ value(in: $0) }) {
+            userInfo[__MPQRErrorTagValueKey] = value
+        }
+        let error = MPQRError(domain: __MPQRErrorDomain, code: code, userInfo: userInfo)
+        error.errorType = __MPQRErrorCode(rawValue: code)!
+        return error
+    }
+}
+
+extension EMVQRError: CustomNSError, LocalizedError {
+    static var errorDomain: String {
+        __MPQRErrorDomain
+    }
+
+    var errorCode: Int {
+        code
+    }
+
+    /// Built on demand when the error is bridged to `NSError` and its `userInfo` is read
+    var errorUserInfo: [String: Any] {
+        var userInfo: [String: Any] = [__MPQRErrorMessageKey: message]
+        if let tagInfo = tagInfo {
+            userInfo[__MPQRErrorTagInfoKey] = tagInfo
+        }
+        if let rootTag = rootTag {
+            // `MPQRError.getRootTag()` reads this key as the two digit tag string
+            userInfo[__MPQRErrorRootTagInfoKey] = EMVQRBytes.tagString(rootTag)
+        }
+        return userInfo
+    }
+
+    var errorDescription: String? {
+        message
+    }
+}
@@ -0,0 +1,155 @@
+//
+//  EMVQRGenerator.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Serialises `AbstractData` values into a single buffer sized up front.
+/// A first pass measures every TLV and checks its length; a second one writes tags in ascending order,
+/// followed by the `6304` CRC header and the CRC, which is folded in while each top level TLV is written.
+enum EMVQRGenerator {
+    /// Serialises `data` followed by the CRC. The returned array is the only allocation, except for a value
+    /// that is neither a string nor a template, which is formatted with `String(describing:)`.
+    /// - Note: Throws `EMVQRError.invalidTagValue` if a value is empty or longer than 99 characters
+    static func generate(_ data: AbstractData) throws -> [UInt8] {
+        let crcTag = EMVQRPayload.Tags.crc
+        let size = try measure(data, skipping: crcTag).bytes + EMVQRCRC16.trailer.count + 4
+        return [UInt8](unsafeUninitializedCapacity: size) { buffer, initializedCount in
+            var writer = Writer(buffer: buffer)
+            var crc = EMVQRCRC16()
+            forEachValue(of: data, skipping: crcTag) { tag, value in
+                let start = writer.position
+                writer.write(tag: tag, value: value)
+                crc.update(buffer: UnsafeRawBufferPointer(UnsafeMutableBufferPointer(rebasing: buffer[start..<writer.position])))
+            }
+            writer.write(EMVQRCRC16.trailer)
+            writer.write(EMVQRCRC16.hexString(crc.finalized()).utf8)
+            initializedCount = writer.position
+        }
+    }
+
+    /// Serialises the TLVs of `data` with a tag in `tags`, in ascending tag order, without CRC
+    /// - Note: Throws `EMVQRError.invalidTagValue` if a value is empty or longer than 99 characters
+    static func serialize(_ data: AbstractData, in tags: ClosedRange<UInt8> = 0...99, skipping skippedTag: UInt8? = nil) throws -> [UInt8] {
+        let size = try measure(data, in: tags, skipping: skippedTag).bytes
+        return [UInt8](unsafeUninitializedCapacity: size) { buffer, initializedCount in
+            var writer = Writer(buffer: buffer)
+            forEachValue(of: data, in: tags, skipping: skippedTag) { tag, value in
+                writer.write(tag: tag, value: value)
+            }
+            initializedCount = writer.position
+        }
+    }
+
+    /// Serialises a single TLV
+    /// - Note: Throws `EMVQRError.invalidTagValue` if `value` is empty or longer than 99 characters
+    static func serialize(tag: UInt8, value: String) throws -> [UInt8] {
+        let count = measureValue(value)
+        guard count.characters > 0 && count.characters <= 99 else {
+            throw EMVQRError.invalidTagValue(tag: tag, offset: 0)
+        }
+        return [UInt8](unsafeUninitializedCapacity: 4 + count.bytes) { buffer, initializedCount in
+            var writer = Writer(buffer: buffer)
+            writer.write(tag: tag, value: value)
+            initializedCount = writer.position
+        }
+    }
+
+    /// Length in characters as written in the header, and size in bytes, of the TLVs of `data` with a tag in `tags`
+    /// - Note: Throws `EMVQRError.invalidTagValue` if a value is empty or longer than 99 characters
+    static func measure(_ data: AbstractData, in tags: ClosedRange<UInt8> = 0...99,
+                        skipping skippedTag: UInt8? = nil) throws -> (characters: Int, bytes: Int) {
+        var characters = 0
+        var bytes = 0
+        try forEachValue(of: data, in: tags, skipping: skippedTag) { tag, value in
+            let count = try (value as? AbstractData).map { try measure($0) } ?? measureValue(value)
+            guard count.characters > 0 && count.characters <= 99 else {
+                throw EMVQRError.invalidTagValue(tag: tag, offset: 0)
+            }
+            characters += 4 + count.characters
+            bytes += 4 + count.bytes
+        }
+        return (characters, bytes)
+    }
+
+    /// Calls `body` with every value of `data` with a tag in `tags`, in ascending tag order
+    fileprivate static func forEachValue(of data: AbstractData, in tags: ClosedRange<UInt8> = 0...99,
+                                         skipping skippedTag: UInt8? = nil, _ body: (UInt8, Any) throws -> Void) rethrows {
+        let table = EMVQRTagTable.cachedTable(for: data.tagType)
+        for tag in tags where tag != skippedTag {
+            guard let tagInfo = table[tag], data.hasTagInfoValue(for: tagInfo),
+                  let value = data.getTagInfoValue(for: tagInfo) else {
+                continue
+            }
+            try body(tag, value)
+        }
+    }
+
+    /// Characters and bytes of a primitive value
+    fileprivate static func measureValue(_ value: Any) -> (characters: Int, bytes: Int) {
+        let string = value as? String ?? String(describing: value)
+        return (string.unicodeScalars.count, string.utf8.count)
+    }
+
+    struct Writer {
+        let buffer: UnsafeMutableBufferPointer<UInt8>
+        private(set) var position = 0
+
+        init(buffer: UnsafeMutableBufferPointer<UInt8>) {
+            self.buffer = buffer
+        }
+
+        /// Writes one TLV of an `AbstractData`, recursing into templates, and returns its length in characters.
+        /// Lengths must have been checked by `EMVQRGenerator.measure` before the buffer was sized.
+        @discardableResult
+        fileprivate mutating func write(tag: UInt8, value: Any) -> Int {
+            writeDigits(Int(tag))
+            if let template = value as? AbstractData {
+                // The template length is only known once its TLVs are written; reserve the header and fill it in after
+                let header = position
+                position += 2
+                var characters = 0
+                EMVQRGenerator.forEachValue(of: template) { tag, value in
+                    characters += write(tag: tag, value: value)
+                }
+                writeDigits(characters, at: header)
+                return 4 + characters
+            }
+            let string = value as? String ?? String(describing: value)
+            let characters = string.unicodeScalars.count
+            writeDigits(characters)
+            write(string.utf8)
+            return 4 + characters
+        }
+
+        mutating func writeDigits(_ value: Int) {
+            writeDigits(value, at: position)
+            position += 2
+        }
+
+        private func writeDigits(_ value: Int, at offset: Int) {
+            buffer[offset] = UInt8(0x30 + value / 10)
+            buffer[offset + 1] = UInt8(0x30 + value % 10)
+        }
+
+        mutating func write<Bytes: Collection>(_ bytes: Bytes) where Bytes.Element == UInt8 {
+            for byte in bytes {
+                buffer[position] = byte
+                position += 1
+            }
+        }
+    }
+}
+
+extension PushPaymentData {
+    /// Single pass counterpart of `generatePushPaymentString()`: validates, then writes every TLV
+    /// and the CRC into one pre-sized buffer. Like the original it replaces the `crc` tag.
+    func generatePushPaymentBytes() throws -> [UInt8] {
+        try validate()
+        let bytes = try EMVQRGenerator.generate(self)
+        crc = String(decoding: bytes.suffix(4), as: UTF8.self)
+        return bytes
+    }
+}
@@ -0,0 +1,79 @@
+//
+//  EMVQRLineReader.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Reads newline delimited payloads from a file handle in fixed size chunks.
+/// Memory stays bounded by `chunkSize + maxLineLength` whatever the input size;
+/// lines longer than `maxLineLength` are skipped and counted.
+struct EMVQRLineReader {
+    static let chunkSize = 64 * 1024
+    /// Well above the 512 characters an EMV QR can hold
+    static let maxLineLength = 4 * 1024
+
+    let handle: FileHandle
+
+    /// Calls `body` with every non empty line, without its `\n` or `\r\n` terminator, and its 1 based line number.
+    /// Line numbers count every physical line, including the empty and overlong ones that are skipped.
+    /// The slice is only valid during the call.
+    /// - Returns: Number of physical lines, and of skipped overlong lines
+    @discardableResult
+    func forEachLine(_ body: (Int, ArraySlice<UInt8>) -> Void) -> (lines: Int, overlong: Int) {
+        var line: [UInt8] = []
+        line.reserveCapacity(EMVQRLineReader.maxLineLength)
+        var isOverlong = false
+        var lines = 0
+        var overlong = 0
+
+        func emit() {
+            lines += 1
+            if isOverlong {
+                overlong += 1
+            } else {
+                let end = line.last == 0x0D ? line.count - 1 : line.count
+                if end > 0 {
+                    body(lines, line[..<end])
+                }
+            }
+            line.removeAll(keepingCapacity: true)
+            isOverlong = false
+        }
+
+        var isAtEnd = false
+        while !isAtEnd {
+            // `readData(ofLength:)` returns autoreleased data on Darwin; drain each chunk before reading the next
+            autoreleasepool {
+                let chunk = handle.readData(ofLength: EMVQRLineReader.chunkSize)
+                if chunk.isEmpty {
+                    isAtEnd = true
+                    return
+                }
+                chunk.withUnsafeBytes { (raw: UnsafeRawBufferPointer) in
+                    var position = 0
+                    while position < raw.count {
+                        let newline = raw[position...].firstIndex(of: 0x0A) ?? raw.count
+                        if !isOverlong {
+                            if line.count + newline - position > EMVQRLineReader.maxLineLength {
+                                isOverlong = true
+                                line.removeAll(keepingCapacity: true)
+                            } else {
+                                line.append(contentsOf: UnsafeRawBufferPointer(rebasing: raw[position..<newline]))
+                            }
+                        }
+                        if newline == raw.count {
+                            break
+                        }
+                        emit()
+                        position = newline + 1
+                    }
+                }
+            }
+        }
+        if !line.isEmpty || isOverlong {
+            emit()
+        }
+        return (lines, overlong)
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  EMVQRLuhn.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Luhn check over ASCII digits, 16 digits per step with `SIMD16<UInt8>`
+/// (lowered to NEON on device and SSE on the simulator).
+enum EMVQRLuhn {
+    private static let zero = SIMD16<UInt8>(repeating: 0x30)
+    private static let nine = SIMD16<UInt8>(repeating: 9)
+    private static let ten = SIMD16<UInt8>(repeating: 10)
+    /// Digits are right aligned in a block of 16, so every second lane from the left is doubled
+    private static let doubledLanes: SIMDMask<SIMD16<Int8>> = {
+        var mask = SIMDMask<SIMD16<Int8>>()
+        for lane in stride(from: 0, to: 16, by: 2) {
+            mask[lane] = true
+        }
+        return mask
+    }()
+
+    /// `true` if `digits` is non empty, numeric and ends with a valid Luhn check digit
+    static func isValid(_ digits: UnsafeRawBufferPointer) -> Bool {
+        guard let base = digits.baseAddress, !digits.isEmpty else {
+            return false
+        }
+        var sum = 0
+        var end = digits.count
+        while end > 0 {
+            let start = max(0, end - 16)
+            var block = zero
+            if end - start == 16 {
+                block = (base + start).loadUnaligned(as: SIMD16<UInt8>.self)
+            } else {
+                for index in start..<end {
+                    block[16 - end + index] = digits[index]
+                }
+            }
+
+            let values = block &- zero
+            if any(values .>= ten) {
+                return false
+            }
+            let twice = values &+ values
+            let doubled = twice.replacing(with: twice &- nine, where: twice .> nine)
+            sum += Int(values.replacing(with: doubled, where: doubledLanes).wrappingSum())
+            end = start
+        }
+        return sum % 10 == 0
+    }
+
+    /// Validates `results.count` IDs packed back to back, `width` digits each
+    static func validate(packed: UnsafeRawBufferPointer, width: Int, into results: UnsafeMutableBufferPointer<Bool>) {
+        precondition(width > 0 && packed.count >= width * results.count)
+        for index in results.indices {
+            results[index] = isValid(UnsafeRawBufferPointer(rebasing: packed[(index * width)..<((index + 1) * width)]))
+        }
+    }
+}
@@ -0,0 +1,141 @@
+//
+//  EMVQRMerchantAccountIndex.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Merchant account information templates (26...51) present in a payload, in tag order,
+/// with the globally unique identifier (sub tag 00) of each.
+struct EMVQRMerchantAccountIndex: Sequence {
+    struct Entry {
+        let tag: UInt8
+        let aid: String?
+    }
+
+    static let tags = EMVQRPayload.Tags.merchantAccountInformation
+
+    /// Bit `n` is set when tag `26 + n` is present
+    private(set) var bitmap: UInt32 = 0
+    private var entries: [Entry] = []
+    /// UTF-8 of every AID with its tag, sorted by bytes then tag, for binary search
+    private var aids: [(bytes: [UInt8], tag: UInt8)] = []
+
+    init() {}
+
+    /// Both builders append in ascending tag order, which costs no reordering;
+    /// any other order is placed by the rank of the tag in `bitmap`.
+    mutating func append(tag: UInt8, aid: String?) {
+        guard EMVQRMerchantAccountIndex.tags.contains(tag), !contains(tag) else {
+            return
+        }
+        entries.insert(Entry(tag: tag, aid: aid), at: rank(of: tag))
+        bitmap |= 1 << UInt32(tag - EMVQRMerchantAccountIndex.tags.lowerBound)
+
+        if let aid = aid {
+            let bytes = Array(aid.utf8)
+            var position = lowerBound(of: bytes)
+            while position < aids.count && aids[position].bytes == bytes && aids[position].tag < tag {
+                position += 1
+            }
+            aids.insert((bytes, tag), at: position)
+        }
+    }
+
+    var count: Int {
+        entries.count
+    }
+
+    var isEmpty: Bool {
+        entries.isEmpty
+    }
+
+    /// Lowest tag account, the one `receive(metadata:)` resolves
+    var first: Entry? {
+        entries.first
+    }
+
+    func contains(_ tag: UInt8) -> Bool {
+        EMVQRMerchantAccountIndex.tags.contains(tag)
+            && bitmap & (1 << UInt32(tag - EMVQRMerchantAccountIndex.tags.lowerBound)) != 0
+    }
+
+    /// Lowest tag account whose AID is `aid` or, with `matchingPrefix`, starts with it.
+    /// A binary search over the AID bytes; no string is compared.
+    func entry<Bytes: Collection>(forAID aid: Bytes, matchingPrefix: Bool = false) -> Entry? where Bytes.Element == UInt8 {
+        var index = lowerBound(of: aid)
+        var tag: UInt8?
+        while index < aids.count {
+            let candidate = aids[index]
+            let matches = matchingPrefix ? candidate.bytes.starts(with: aid) : candidate.bytes.elementsEqual(aid)
+            guard matches else {
+                break
+            }
+            tag = min(tag ?? candidate.tag, candidate.tag)
+            if !matchingPrefix {
+                // Equal AIDs are sorted by tag, the first is the lowest
+                break
+            }
+            index += 1
+        }
+        return tag.map { entries[rank(of: $0)] }
+    }
+
+    func entry(forAID aid: String, matchingPrefix: Bool = false) -> Entry? {
+        entry(forAID: aid.utf8, matchingPrefix: matchingPrefix)
+    }
+
+    /// Number of present tags below `tag`, which is the index of `tag` in `entries` when present
+    private func rank(of tag: UInt8) -> Int {
+        let bit: UInt32 = 1 << UInt32(tag - EMVQRMerchantAccountIndex.tags.lowerBound)
+        return (bitmap & (bit - 1)).nonzeroBitCount
+    }
+
+    /// Index of the first AID not ordered before `bytes`
+    private func lowerBound<Bytes: Collection>(of bytes: Bytes) -> Int where Bytes.Element == UInt8 {
+        var low = 0
+        var high = aids.count
+        while low < high {
+            let middle = (low + high) / 2
+            if aids[middle].bytes.lexicographicallyPrecedes(bytes) {
+                low = middle + 1
+            } else {
+                high = middle
+            }
+        }
+        return low
+    }
+
+    func makeIterator() -> IndexingIterator<[Entry]> {
+        entries.makeIterator()
+    }
+}
+
+extension EMVQRPayload {
+    /// Index of the merchant account templates, read from the presence bitmap of the top level template.
+    /// Each AID is read from the template's span without building the other sub tags.
+    var merchantAccounts: EMVQRMerchantAccountIndex {
+        var index = EMVQRMerchantAccountIndex()
+        for span in data.store where EMVQRMerchantAccountIndex.tags.contains(span.tag) {
+            let aid = try? EMVQRData(bytes: bytes, range: span.offset..<span.end).value(for: Tags.globallyUniqueIdentifier)
+            index.append(tag: span.tag, aid: aid)
+        }
+        return index
+    }
+}
+
+extension PushPaymentData {
+    /// Index of the merchant account templates. Probes presence through the tag table,
+    /// so absent tags cost a bit test instead of an `NSError` from `getMAIData(forTagString:)`.
+    var merchantAccountIndex: EMVQRMerchantAccountIndex {
+        var index = EMVQRMerchantAccountIndex()
+        for tag in EMVQRMerchantAccountIndex.tags {
+            guard let tagInfo = EMVQRTagTable.pushPayment[tag], hasTagInfoValue(for: tagInfo) else {
+                continue
+            }
+            index.append(tag: tag, aid: (getTagInfoValue(for: tagInfo) as? MAIData)?.AID)
+        }
+        return index
+    }
+}
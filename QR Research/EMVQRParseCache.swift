@@ -0,0 +1,205 @@
+//
+//  EMVQRParseCache.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Bounded LRU cache of parse results for static QR codes, which a till shows for every sale.
+/// Entries are keyed by a hash of the payload bytes; a lookup hashes and compares the string's UTF-8 in place,
+/// and the bytes are only copied when a payload is stored. Dynamic payloads (point of initiation `12`)
+/// carry a per sale amount and bypass the cache, as do payloads that cannot be scanned or lack a CRC trailer.
+/// Lookups are safe from any thread. A hit returns the instance stored by the first parse, shared by
+/// every caller. `PushPaymentData` is mutable and the cache cannot prevent writes to it, e.g. by
+/// `generatePushPaymentBytes()` setting `crc`: treat it as immutable.
+final class EMVQRParseCache {
+    struct Statistics {
+        var hits = 0
+        var misses = 0
+        var evictions = 0
+        var bypasses = 0
+    }
+
+    /// Doubly linked LRU list kept in arrays; slot indices are stable while an entry is cached
+    private struct Entry {
+        let hash: Int
+        let bytes: [UInt8]
+        let data: PushPaymentData
+        var previous: Int
+        var next: Int
+    }
+
+    let capacity: Int
+    private let parse: (String) throws -> PushPaymentData
+    private let lock = NSLock()
+    /// Slot of each cached payload by hash; a colliding payload replaces the entry
+    private var slots: [Int: Int] = [:]
+    private var entries: [Entry] = []
+    /// Most and least recently used slot, `-1` when empty
+    private var head = -1
+    private var tail = -1
+    private var counters = Statistics()
+
+    /// - Parameter parse: Parser run on a miss, `parse(string:)` by default. Must be safe to call concurrently.
+    init(capacity: Int, parse: @escaping (String) throws -> PushPaymentData = { try MPQRParser.parse(string: $0) }) {
+        precondition(capacity > 0, "EMVQRParseCache needs room for at least one entry")
+        self.capacity = capacity
+        self.parse = parse
+        slots.reserveCapacity(capacity)
+        entries.reserveCapacity(capacity)
+    }
+
+    var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return counters
+    }
+
+    var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return entries.count
+    }
+
+    /// Cached result for `string`, parsing and storing it on a miss. Errors are not cached.
+    func data(for string: String) throws -> PushPaymentData {
+        if let result = string.utf8.withContiguousStorageIfAvailable({ lookup(UnsafeRawBufferPointer($0), string) }) {
+            return try result.get()
+        }
+        // Bridged strings without contiguous UTF-8 are copied once
+        return try Array(string.utf8).withUnsafeBytes { lookup($0, string) }.get()
+    }
+
+    private func lookup(_ payload: UnsafeRawBufferPointer, _ string: String) -> Result<PushPaymentData, Error> {
+        guard EMVQRParseCache.isCacheable(payload) else {
+            lock.lock()
+            counters.bypasses += 1
+            lock.unlock()
+            return Result { try parse(string) }
+        }
+        var hasher = Hasher()
+        hasher.combine(bytes: payload)
+        let hash = hasher.finalize()
+
+        lock.lock()
+        if let slot = slots[hash], entries[slot].bytes.elementsEqual(payload) {
+            counters.hits += 1
+            moveToFront(slot)
+            let data = entries[slot].data
+            lock.unlock()
+            return .success(data)
+        }
+        counters.misses += 1
+        lock.unlock()
+
+        // Parse outside the lock so one slow payload does not block other lookups
+        let result = Result { try parse(string) }
+        guard case .success(let data) = result else {
+            return result
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+        if let slot = slots[hash], entries[slot].bytes.elementsEqual(payload) {
+            // Another thread parsed the same payload meanwhile; keep a single shared instance
+            return .success(entries[slot].data)
+        }
+        insert(hash, Array(payload), data)
+        return .success(data)
+    }
+
+    func removeAll() {
+        lock.lock()
+        defer { lock.unlock() }
+        slots.removeAll(keepingCapacity: true)
+        entries.removeAll(keepingCapacity: true)
+        head = -1
+        tail = -1
+    }
+
+    // MARK: - Key
+
+    /// `false` for dynamic payloads and for payloads that cannot be scanned or lack a CRC trailer
+    private static func isCacheable(_ payload: UnsafeRawBufferPointer) -> Bool {
+        payload.count >= 8
+            && EMVQRCRC16.parseHex(UnsafeRawBufferPointer(rebasing: payload[(payload.count - 4)...])) != nil
+            && isStatic(payload)
+    }
+
+    private static func isStatic(_ payload: UnsafeRawBufferPointer) -> Bool {
+        let tags = EMVQRPayload.Tags.self
+        var scanner = EMVQRScanner(bytes: payload)
+        while let span = try? scanner.next() {
+            if span.tag == tags.pointOfInitiationMethod {
+                return !EMVQRValidator.equals(payload, span, EMVQRConstants.pointOfInitiationMethodDynamic)
+            }
+        }
+        // Without tag 01 the payload is static, unless the scan stopped on a malformed header
+        return scanner.isAtEnd
+    }
+
+    // MARK: - LRU list, called with the lock held
+
+    private func insert(_ hash: Int, _ bytes: [UInt8], _ data: PushPaymentData) {
+        let slot: Int
+        if let colliding = slots[hash] {
+            slot = colliding
+            unlink(slot)
+            entries[slot] = Entry(hash: hash, bytes: bytes, data: data, previous: -1, next: -1)
+        } else if entries.count < capacity {
+            slot = entries.count
+            entries.append(Entry(hash: hash, bytes: bytes, data: data, previous: -1, next: -1))
+        } else {
+            slot = tail
+            unlink(slot)
+            slots[entries[slot].hash] = nil
+            entries[slot] = Entry(hash: hash, bytes: bytes, data: data, previous: -1, next: -1)
+            counters.evictions += 1
+        }
+        slots[hash] = slot
+        linkAtFront(slot)
+    }
+
+    private func moveToFront(_ slot: Int) {
+        guard slot != head else {
+            return
+        }
+        unlink(slot)
+        linkAtFront(slot)
+    }
+
+    private func unlink(_ slot: Int) {
+        let previous = entries[slot].previous
+        let next = entries[slot].next
+        if previous >= 0 {
+            entries[previous].next = next
+        } else {
+            head = next
+        }
+        if next >= 0 {
+            entries[next].previous = previous
+        } else {
+            tail = previous
+        }
+    }
+
+    private func linkAtFront(_ slot: Int) {
+        entries[slot].previous = -1
+        entries[slot].next = head
+        if head >= 0 {
+            entries[head].previous = slot
+        }
+        head = slot
+        if tail < 0 {
+            tail = slot
+        }
+    }
+}
+
+extension MPQRParser {
+    /// `parse(string:)` through `cache`; dynamic payloads are always parsed afresh
+    static func parse(string: String, cache: EMVQRParseCache) throws -> PushPaymentData {
+        try cache.data(for: string)
+    }
+}
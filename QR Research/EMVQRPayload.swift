@@ -0,0 +1,138 @@
+//
+//  EMVQRPayload.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Lazily parsed QR payload.
+/// Only the top level template is scanned up front; nested templates (05, 26...51, 62, 64, 80...99)
+/// are kept as byte spans and decoded on first access, then cached.
+/// - Note: Decoding mutates the cache, so an instance must not be shared between threads without synchronisation.
+final class EMVQRPayload {
+    enum Tags {
+        static let payloadFormatIndicator: UInt8 = 0
+        static let pointOfInitiationMethod: UInt8 = 1
+        static let masterCardData: UInt8 = 5
+        static let merchantAccountInformation: ClosedRange<UInt8> = 26...51
+        static let merchantCategoryCode: UInt8 = 52
+        static let transactionCurrencyCode: UInt8 = 53
+        static let transactionAmount: UInt8 = 54
+        static let countryCode: UInt8 = 58
+        static let merchantName: UInt8 = 59
+        static let merchantCity: UInt8 = 60
+        static let postalCode: UInt8 = 61
+        static let additionalData: UInt8 = 62
+        static let crc: UInt8 = 63
+        static let languageData: UInt8 = 64
+        static let unreservedTemplates: ClosedRange<UInt8> = 80...99
+
+        /// Sub tag 00 of merchant account and unreserved templates
+        static let globallyUniqueIdentifier: UInt8 = 0
+        /// Sub tags of additional data
+        static let billNumber: UInt8 = 1
+        static let purpose: UInt8 = 8
+    }
+
+    let data: EMVQRData
+    private var templates: [EMVQRData?] = []
+
+    init(data: EMVQRData) {
+        self.data = data
+    }
+
+    var bytes: [UInt8] {
+        data.bytes
+    }
+
+    /// Decodes the template stored under `tag` on first call
+    /// - Returns: `nil` if the tag is absent
+    /// - Note: Throws `EMVQRError` if the template content is malformed
+    func template(for tag: UInt8) throws -> EMVQRData? {
+        guard let span = data.span(for: tag) else {
+            return nil
+        }
+        if templates.isEmpty {
+            templates = [EMVQRData?](repeating: nil, count: EMVQRTagStore.capacity)
+        } else if let template = templates[Int(tag)] {
+            return template
+        }
+        let template = try EMVQRData(bytes: data.bytes, range: span.offset..<span.end, rootTag: tag)
+        templates[Int(tag)] = template
+        return template
+    }
+
+    // MARK: - Convenience accessors
+
+    var payloadFormatIndicator: String? {
+        data.value(for: Tags.payloadFormatIndicator)
+    }
+
+    var pointOfInitiationMethod: String? {
+        data.value(for: Tags.pointOfInitiationMethod)
+    }
+
+    var isDynamic: Bool {
+        data.value(for: Tags.pointOfInitiationMethod, equals: EMVQRConstants.pointOfInitiationMethodDynamic)
+    }
+
+    var merchantCategoryCode: String? {
+        data.value(for: Tags.merchantCategoryCode)
+    }
+
+    var transactionCurrencyCode: String? {
+        data.value(for: Tags.transactionCurrencyCode)
+    }
+
+    var transactionAmount: String? {
+        data.value(for: Tags.transactionAmount)
+    }
+
+    var countryCode: String? {
+        data.value(for: Tags.countryCode)
+    }
+
+    var merchantName: String? {
+        data.value(for: Tags.merchantName)
+    }
+
+    var merchantCity: String? {
+        data.value(for: Tags.merchantCity)
+    }
+
+    var postalCode: String? {
+        data.value(for: Tags.postalCode)
+    }
+
+    var crc: String? {
+        data.value(for: Tags.crc)
+    }
+
+    var additionalData: EMVQRData? {
+        try? template(for: Tags.additionalData)
+    }
+
+    var languageData: EMVQRData? {
+        try? template(for: Tags.languageData)
+    }
+
+    var masterCardData: EMVQRData? {
+        try? template(for: Tags.masterCardData)
+    }
+
+    var billNumber: String? {
+        additionalData?.value(for: Tags.billNumber)
+    }
+
+    var purpose: String? {
+        additionalData?.value(for: Tags.purpose)
+    }
+
+    /// Merchant account information template 26...51
+    func maiData(for tag: UInt8) -> EMVQRData? {
+        guard Tags.merchantAccountInformation.contains(tag) else {
+            return nil
+        }
+        return try? template(for: tag)
+    }
+}
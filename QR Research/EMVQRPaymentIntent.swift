@@ -0,0 +1,119 @@
+//
+//  EMVQRPaymentIntent.swift
+//  QR Research
+//
+
+import Foundation
+
+/// The fields a wallet reads from a scanned QR, extracted in one pass with the CRC checked.
+/// Only the CRC is checked: run `MPQRParser.parseFailFast(string:)` first where tag formats and mandatory tags matter.
+/// Only spans into the payload are stored, so the struct is flat and extraction builds no strings;
+/// `value(_:in:)` builds a `String` for the fields actually used.
+struct EMVQRPaymentIntent {
+    enum Field {
+        case aid
+        case currency
+        case amount
+        case merchantName
+        case purpose
+        case billNumber
+    }
+
+    /// Lowest merchant account template present, 26...51, which the AID is taken from as `getMAIData` probing did
+    private(set) var accountTag: UInt8?
+    private(set) var aid: EMVQRSpan?
+    private(set) var currency: EMVQRSpan?
+    private(set) var amount: EMVQRSpan?
+    private(set) var merchantName: EMVQRSpan?
+    private(set) var purpose: EMVQRSpan?
+    private(set) var billNumber: EMVQRSpan?
+
+    /// - Note: Throws `EMVQRError.invalidFormat` on a malformed payload, `.invalidTagValue` for a missing or wrong CRC
+    static func extract(from string: String) throws -> EMVQRPaymentIntent {
+        var string = string
+        return try string.withUTF8 { try extract(from: UnsafeRawBufferPointer($0)) }
+    }
+
+    static func extract(from payload: UnsafeRawBufferPointer) throws -> EMVQRPaymentIntent {
+        let tags = EMVQRPayload.Tags.self
+        var intent = EMVQRPaymentIntent()
+        var crc: EMVQRSpan?
+        var scanner = EMVQRScanner(bytes: payload)
+        while let span = try scanner.next() {
+            switch span.tag {
+            case tags.merchantAccountInformation where span.tag < (intent.accountTag ?? .max):
+                intent.accountTag = span.tag
+                intent.aid = try nested(tags.globallyUniqueIdentifier, in: span, of: payload)
+            case tags.transactionCurrencyCode:
+                intent.currency = span
+            case tags.transactionAmount:
+                intent.amount = span
+            case tags.merchantName:
+                intent.merchantName = span
+            case tags.additionalData:
+                var additional = EMVQRScanner(bytes: payload, range: span.offset..<span.end)
+                while let sub = try additional.next() {
+                    if sub.tag == tags.billNumber {
+                        intent.billNumber = sub
+                    } else if sub.tag == tags.purpose {
+                        intent.purpose = sub
+                    }
+                }
+            case tags.crc:
+                crc = span
+            default:
+                break
+            }
+        }
+
+        guard let crcSpan = crc, crcSpan.length == 4, crcSpan.end == payload.count,
+              EMVQRCRC16.isValid(payload: payload) else {
+            throw EMVQRError.invalidTagValue(tag: tags.crc, offset: crc?.offset ?? payload.count)
+        }
+        return intent
+    }
+
+    private static func nested(_ tag: UInt8, in span: EMVQRSpan, of payload: UnsafeRawBufferPointer) throws -> EMVQRSpan? {
+        var scanner = EMVQRScanner(bytes: payload, range: span.offset..<span.end)
+        while let sub = try scanner.next() {
+            if sub.tag == tag {
+                return sub
+            }
+        }
+        return nil
+    }
+
+    func span(_ field: Field) -> EMVQRSpan? {
+        switch field {
+        case .aid:
+            return aid
+        case .currency:
+            return currency
+        case .amount:
+            return amount
+        case .merchantName:
+            return merchantName
+        case .purpose:
+            return purpose
+        case .billNumber:
+            return billNumber
+        }
+    }
+
+    /// Value of `field`, read from the payload the intent was extracted from.
+    /// Returns `nil` if the span lies outside `payload`, e.g. when given a different payload.
+    /// - Note: `withUTF8` copies a bridged `NSString` on every call; call `makeContiguousUTF8()` on the payload
+    ///   once before reading several fields.
+    func value(_ field: Field, in payload: String) -> String? {
+        guard let span = span(field) else {
+            return nil
+        }
+        var payload = payload
+        return payload.withUTF8 { utf8 -> String? in
+            guard span.end <= utf8.count else {
+                return nil
+            }
+            return String(decoding: UnsafeRawBufferPointer(rebasing: UnsafeRawBufferPointer(utf8)[span.offset..<span.end]), as: UTF8.self)
+        }
+    }
+}
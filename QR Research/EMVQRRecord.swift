@@ -0,0 +1,40 @@
+//
+//  EMVQRRecord.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Fields read by `ViewController.receive(metadata:)`, flattened for export
+struct EMVQRRecord {
+    static let csvHeader = "line,aid,currency,amount,merchant_name,purpose,bill_number"
+
+    var aid: String?
+    var currency: String?
+    var amount: String?
+    var merchantName: String?
+    var purpose: String?
+    var billNumber: String?
+
+    init(payloadData: PushPaymentData) {
+        aid = payloadData.merchantAccountIndex.first?.aid
+        currency = payloadData.transactionCurrencyCode
+        amount = payloadData.transactionAmount
+        merchantName = payloadData.merchantName
+        purpose = payloadData.additionalData?.purpose
+        billNumber = payloadData.additionalData?.billNumber
+    }
+
+    func csvLine(number: Int) -> String {
+        let fields = [aid, currency, amount, merchantName, purpose, billNumber].map { EMVQRRecord.csvField($0 ?? "") }
+        return "\(number)," + fields.joined(separator: ",") + "\n"
+    }
+
+    private static func csvField(_ value: String) -> String {
+        guard value.contains(where: { $0 == "," || $0 == "\"" || $0 == "\n" || $0 == "\r" }) else {
+            return value
+        }
+        return "\"" + value.replacingOccurrences(of: "\"", with: "\"\"") + "\""
+    }
+}
@@ -0,0 +1,138 @@
+//
+//  EMVQRScanner.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Position of one TLV object inside a payload, as UTF-8 byte offsets.
+struct EMVQRSpan: Equatable {
+    /// Numeric tag, 0...99
+    let tag: UInt8
+    /// Offset of the first value byte
+    let offset: Int
+    /// Number of value bytes (not characters)
+    let length: Int
+
+    var end: Int {
+        offset + length
+    }
+
+    /// Offset of the two digit tag header
+    var headerOffset: Int {
+        offset - 4
+    }
+}
+
+/// Walks the UTF-8 bytes of a payload once and returns TLV objects as spans.
+/// Nothing is copied; strings are only built by `EMVQRTLV` when a property is read.
+/// Works on `[UInt8]` as well as on borrowed memory such as `String.withUTF8`.
+struct EMVQRScanner<Bytes: RandomAccessCollection> where Bytes.Element == UInt8, Bytes.Index == Int {
+    private let bytes: Bytes
+    private let end: Int
+    private(set) var position: Int
+
+    init(bytes: Bytes, range: Range<Int>? = nil) {
+        self.bytes = bytes
+        self.position = range?.lowerBound ?? bytes.startIndex
+        self.end = range?.upperBound ?? bytes.endIndex
+    }
+
+    var isAtEnd: Bool {
+        position >= end
+    }
+
+    /// Returns the next span, or `nil` at the end of the range.
+    /// Throws `EMVQRError.invalidFormat` when the header is malformed or the value is truncated.
+    mutating func next() throws -> EMVQRSpan? {
+        guard position < end else {
+            return nil
+        }
+        guard end - position >= 4,
+              let tag = EMVQRBytes.twoDigits(bytes, at: position),
+              let count = EMVQRBytes.twoDigits(bytes, at: position + 2) else {
+            throw EMVQRError.invalidFormat(offset: position)
+        }
+
+        let valueOffset = position + 4
+        guard let length = EMVQRBytes.byteLength(of: count, in: bytes, from: valueOffset, limit: end) else {
+            throw EMVQRError.invalidFormat(offset: position)
+        }
+
+        position = valueOffset + length
+        return EMVQRSpan(tag: UInt8(tag), offset: valueOffset, length: length)
+    }
+}
+
+/// Header and length helpers shared by the scanner and its callers
+enum EMVQRBytes {
+    @inline(__always)
+    static func twoDigits<Bytes: RandomAccessCollection>(_ bytes: Bytes, at index: Int) -> Int?
+        where Bytes.Element == UInt8, Bytes.Index == Int {
+        let high = bytes[index] &- 0x30
+        let low = bytes[index + 1] &- 0x30
+        guard high < 10, low < 10 else {
+            return nil
+        }
+        return Int(high) * 10 + Int(low)
+    }
+
+    /// Two digit form of a numeric tag, as the SDK's `TagInfo` and root tags spell it
+    static func tagString(_ tag: UInt8) -> String {
+        tag < 10 ? "0\(tag)" : "\(tag)"
+    }
+
+    /// EMVCo lengths count characters. For ASCII values that is the byte count;
+    /// otherwise UTF-8 lead bytes are counted until `characters` have been consumed.
+    static func byteLength<Bytes: RandomAccessCollection>(of characters: Int, in bytes: Bytes, from start: Int, limit: Int) -> Int?
+        where Bytes.Element == UInt8, Bytes.Index == Int {
+        guard start + characters <= limit else {
+            return nil
+        }
+        var index = start
+        while index < start + characters {
+            if bytes[index] >= 0x80 {
+                return multiByteLength(of: characters, in: bytes, from: start, limit: limit)
+            }
+            index += 1
+        }
+        return characters
+    }
+
+    private static func multiByteLength<Bytes: RandomAccessCollection>(of characters: Int, in bytes: Bytes, from start: Int, limit: Int) -> Int?
+        where Bytes.Element == UInt8, Bytes.Index == Int {
+        var index = start
+        var remaining = characters
+        while remaining > 0 {
+            guard index < limit else {
+                return nil
+            }
+            index += 1
+            while index < limit && bytes[index] & 0xC0 == 0x80 {
+                index += 1
+            }
+            remaining -= 1
+        }
+        return index - start
+    }
+}
+
+/// TLV object backed by a span of the payload bytes.
+/// Mirrors `TLV` from MPQRCoreSDK, but `tag` and `value` are materialised on read.
+struct EMVQRTLV {
+    let bytes: [UInt8]
+    let span: EMVQRSpan
+
+    var tag: String {
+        EMVQRBytes.tagString(span.tag)
+    }
+
+    /// Length in characters, as encoded in the payload
+    var length: Int {
+        EMVQRBytes.twoDigits(bytes, at: span.headerOffset + 2) ?? span.length
+    }
+
+    var value: String {
+        String(decoding: bytes[span.offset..<span.end], as: UTF8.self)
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  EMVQRStreamProcessor.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Headless processing of a file of EMVCo payloads, one per line, into CSV records.
+/// Input is read in chunks and output is flushed in blocks, so memory use does not grow with the input.
+enum EMVQRStreamProcessor {
+    static let outputBufferSize = 64 * 1024
+
+    struct Statistics {
+        /// Physical lines of the input, including skipped empty and overlong ones
+        var lines = 0
+        var parsed = 0
+        var failed = 0
+        var overlong = 0
+    }
+
+    static func process(inputPath: String, outputPath: String) throws -> Statistics {
+        let input = try FileHandle(forReadingFrom: URL(fileURLWithPath: inputPath))
+        defer { input.closeFile() }
+        FileManager.default.createFile(atPath: outputPath, contents: nil)
+        let output = try FileHandle(forWritingTo: URL(fileURLWithPath: outputPath))
+        defer { output.closeFile() }
+        return process(input: input, output: output)
+    }
+
+    /// Use `FileHandle.standardInput` / `FileHandle.standardOutput` to run as a filter
+    static func process(input: FileHandle, output: FileHandle,
+                        parse: (String) throws -> PushPaymentData = { try MPQRParser.parse(string: $0) }) -> Statistics {
+        var statistics = Statistics()
+        var buffer = Data()
+        buffer.reserveCapacity(outputBufferSize)
+        buffer.append(contentsOf: (EMVQRRecord.csvHeader + "\n").utf8)
+
+        let counts = EMVQRLineReader(handle: input).forEachLine { number, line in
+            autoreleasepool {
+                do {
+                    let payloadData = try parse(String(decoding: line, as: UTF8.self))
+                    let record = EMVQRRecord(payloadData: payloadData)
+                    buffer.append(contentsOf: record.csvLine(number: number).utf8)
+                    statistics.parsed += 1
+                } catch {
+                    statistics.failed += 1
+                }
+            }
+            if buffer.count >= outputBufferSize {
+                output.write(buffer)
+                buffer.removeAll(keepingCapacity: true)
+            }
+        }
+        output.write(buffer)
+        statistics.lines = counts.lines
+        statistics.overlong = counts.overlong
+        return statistics
+    }
+}
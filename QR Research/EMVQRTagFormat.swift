@@ -0,0 +1,170 @@
+//
+//  EMVQRTagFormat.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Value format of one tag.
+/// Replaces the regex `pattern` of `TagInfo` with a hand written character class check.
+struct EMVQRTagFormat {
+    enum Kind {
+        /// Digits only
+        case numeric
+        /// Printable ASCII 0x20...0x7E
+        case alphanumericSpecial
+        /// Digits with at most one `.`
+        case amount
+        /// Any characters, e.g. merchant name in alternate language
+        case any
+        /// Nested TLV template, validated by its own table
+        case template
+        /// Reserved for future use, never valid
+        case reserved
+    }
+
+    let kind: Kind
+    let minLength: Int
+    let maxLength: Int
+
+    static func numeric(_ length: Int) -> EMVQRTagFormat {
+        EMVQRTagFormat(kind: .numeric, minLength: length, maxLength: length)
+    }
+
+    static func alphanumericSpecial(_ minLength: Int = 1, _ maxLength: Int) -> EMVQRTagFormat {
+        EMVQRTagFormat(kind: .alphanumericSpecial, minLength: minLength, maxLength: maxLength)
+    }
+
+    static func amount(_ maxLength: Int) -> EMVQRTagFormat {
+        EMVQRTagFormat(kind: .amount, minLength: 1, maxLength: maxLength)
+    }
+
+    static func any(_ maxLength: Int) -> EMVQRTagFormat {
+        EMVQRTagFormat(kind: .any, minLength: 1, maxLength: maxLength)
+    }
+
+    static let template = EMVQRTagFormat(kind: .template, minLength: 1, maxLength: 99)
+    static let reserved = EMVQRTagFormat(kind: .reserved, minLength: 0, maxLength: 0)
+
+    /// Checks length and character class of a value given as UTF-8 bytes
+    func matches(_ value: UnsafeRawBufferPointer) -> Bool {
+        switch kind {
+        case .reserved:
+            return false
+        case .template:
+            return value.count >= minLength && value.count <= maxLength
+        case .any:
+            let characters = EMVQRCharacterClass.characterCount(value)
+            return characters >= minLength && characters <= maxLength
+        case .numeric, .alphanumericSpecial, .amount:
+            guard value.count >= minLength && value.count <= maxLength else {
+                return false
+            }
+            return EMVQRTagFormat.matchesClass(kind, value)
+        }
+    }
+
+    private static func matchesClass(_ kind: Kind, _ value: UnsafeRawBufferPointer) -> Bool {
+        switch kind {
+        case .numeric:
+            return EMVQRCharacterClass.isNumeric(value)
+        case .alphanumericSpecial:
+            return EMVQRCharacterClass.isAlphanumericSpecial(value)
+        case .amount:
+            return EMVQRCharacterClass.isAmount(value)
+        default:
+            return true
+        }
+    }
+}
+
+/// Formats of every tag 00...99, per template, built once and shared.
+/// Mirrors `PPTag`, `AdditionalDataTag`, `LanguageTag`, `MasterCardDataTag` and `TemplateDataTag`.
+enum EMVQRTagFormats {
+    static let pushPayment: [EMVQRTagFormat] = {
+        var formats = [EMVQRTagFormat](repeating: .reserved, count: 100)
+        formats[0] = .numeric(2)
+        formats[1] = .numeric(2)
+        for tag in 2...4 {
+            formats[tag] = .alphanumericSpecial(99)
+        }
+        formats[5] = .template
+        for tag in 6...25 {
+            formats[tag] = .alphanumericSpecial(99)
+        }
+        for tag in 26...51 {
+            formats[tag] = .template
+        }
+        formats[52] = .numeric(4)
+        formats[53] = .numeric(3)
+        formats[54] = .amount(EMVQRConstants.amountLengthLimit)
+        formats[55] = .numeric(2)
+        formats[56] = .amount(EMVQRConstants.amountLengthLimit)
+        formats[57] = .amount(5)
+        formats[58] = .alphanumericSpecial(2, 2)
+        formats[59] = .alphanumericSpecial(EMVQRConstants.fullNameLengthLimit)
+        formats[60] = .alphanumericSpecial(15)
+        formats[61] = .alphanumericSpecial(10)
+        formats[62] = .template
+        formats[63] = .alphanumericSpecial(4, 4)
+        formats[64] = .template
+        for tag in 80...99 {
+            formats[tag] = .template
+        }
+        return formats
+    }()
+
+    static let additionalData: [EMVQRTagFormat] = {
+        var formats = [EMVQRTagFormat](repeating: .reserved, count: 100)
+        for tag in 1...8 {
+            formats[tag] = .alphanumericSpecial(EMVQRConstants.billNumberSymbolLimit)
+        }
+        formats[9] = .alphanumericSpecial(3)
+        // Merchant tax id and merchant channel
+        formats[10] = .alphanumericSpecial(20)
+        formats[11] = .alphanumericSpecial(3, 3)
+        for tag in 50...99 {
+            formats[tag] = .template
+        }
+        return formats
+    }()
+
+    static let language: [EMVQRTagFormat] = {
+        var formats = [EMVQRTagFormat](repeating: .reserved, count: 100)
+        formats[0] = .alphanumericSpecial(2, 2)
+        formats[1] = .any(EMVQRConstants.fullNameLengthLimit)
+        formats[2] = .any(15)
+        return formats
+    }()
+
+    static let masterCard: [EMVQRTagFormat] = {
+        var formats = [EMVQRTagFormat](repeating: .reserved, count: 100)
+        for tag in 1...4 {
+            formats[tag] = .alphanumericSpecial(99)
+        }
+        return formats
+    }()
+
+    /// Merchant account information (26...51) and unrestricted data (80...99) templates
+    static let template: [EMVQRTagFormat] = {
+        var formats = [EMVQRTagFormat](repeating: .alphanumericSpecial(99), count: 100)
+        formats[0] = .alphanumericSpecial(32)
+        return formats
+    }()
+
+    /// Format table of the template stored under a top level tag, `nil` if the tag is not a template
+    static func nested(in tag: UInt8) -> [EMVQRTagFormat]? {
+        switch tag {
+        case 5:
+            return masterCard
+        case 26...51, 80...99:
+            return template
+        case 62:
+            return additionalData
+        case 64:
+            return language
+        default:
+            return nil
+        }
+    }
+}
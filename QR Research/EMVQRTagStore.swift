@@ -0,0 +1,109 @@
+//
+//  EMVQRTagStore.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Spans of one template, stored in a fixed 100 slot array indexed by the numeric tag.
+/// A presence bitmap gives O(1) lookup, count and ordered iteration without hashing `TagInfo` keys
+/// as `AbstractData` does.
+struct EMVQRTagStore: Sequence {
+    static let capacity = 100
+
+    /// `offset << 16 | length` per tag
+    private var slots = [UInt64](repeating: 0, count: EMVQRTagStore.capacity)
+    /// Presence of tags 0...63
+    private var low: UInt64 = 0
+    /// Presence of tags 64...99
+    private var high: UInt64 = 0
+
+    init() {}
+
+    var count: Int {
+        low.nonzeroBitCount + high.nonzeroBitCount
+    }
+
+    var isEmpty: Bool {
+        low == 0 && high == 0
+    }
+
+    @inline(__always)
+    func contains(_ tag: UInt8) -> Bool {
+        tag < 64 ? low & (1 << UInt64(tag)) != 0 : high & (1 << UInt64(tag - 64)) != 0
+    }
+
+    subscript(tag: UInt8) -> EMVQRSpan? {
+        guard contains(tag) else {
+            return nil
+        }
+        let slot = slots[Int(tag)]
+        return EMVQRSpan(tag: tag, offset: Int(slot >> 16), length: Int(slot & 0xFFFF))
+    }
+
+    /// Stores `span` under its tag
+    /// - Returns: `false`, leaving the store unchanged, if the tag is already present
+    @discardableResult
+    mutating func insert(_ span: EMVQRSpan) -> Bool {
+        guard !contains(span.tag) else {
+            return false
+        }
+        slots[Int(span.tag)] = UInt64(span.offset) << 16 | UInt64(span.length)
+        if span.tag < 64 {
+            low |= 1 << UInt64(span.tag)
+        } else {
+            high |= 1 << UInt64(span.tag - 64)
+        }
+        return true
+    }
+
+    mutating func remove(_ tag: UInt8) {
+        if tag < 64 {
+            low &= ~(1 << UInt64(tag))
+        } else {
+            high &= ~(1 << UInt64(tag - 64))
+        }
+    }
+
+    /// `true` if any tag in `range` is present
+    func containsAny(in range: ClosedRange<UInt8>) -> Bool {
+        range.contains { contains($0) }
+    }
+
+    // MARK: - Sequence
+
+    /// Iterates present spans in ascending tag order
+    struct Iterator: IteratorProtocol {
+        private let store: EMVQRTagStore
+        private var low: UInt64
+        private var high: UInt64
+
+        fileprivate init(store: EMVQRTagStore) {
+            self.store = store
+            self.low = store.low
+            self.high = store.high
+        }
+
+        mutating func next() -> EMVQRSpan? {
+            let tag: UInt8
+            if low != 0 {
+                tag = UInt8(low.trailingZeroBitCount)
+                low &= low - 1
+            } else if high != 0 {
+                tag = UInt8(high.trailingZeroBitCount + 64)
+                high &= high - 1
+            } else {
+                return nil
+            }
+            return store[tag]
+        }
+    }
+
+    func makeIterator() -> Iterator {
+        Iterator(store: self)
+    }
+
+    var underestimatedCount: Int {
+        count
+    }
+}
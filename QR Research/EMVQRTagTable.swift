@@ -0,0 +1,113 @@
+//
+//  EMVQRTagTable.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// `TagInfo` objects of one `Tag` class in a 100 entry table indexed by the numeric tag.
+/// Built once from `allTags`; resolving a tag is a digit conversion instead of an array scan.
+struct EMVQRTagTable {
+    static let pushPayment = EMVQRTagTable(PPTag.self)
+    static let additionalData = EMVQRTagTable(AdditionalDataTag.self)
+    static let language = EMVQRTagTable(LanguageTag.self)
+    static let masterCard = EMVQRTagTable(MasterCardDataTag.self)
+    static let template = EMVQRTagTable(TemplateDataTag.self)
+
+    private let tags: [TagInfo?]
+
+    init(_ type: Tag.Type) {
+        var tags = [TagInfo?](repeating: nil, count: EMVQRTagStore.capacity)
+        for tagInfo in type.allTags {
+            if let tag = Int(tagInfo.tag), tags.indices.contains(tag) {
+                tags[tag] = tagInfo
+            }
+        }
+        self.tags = tags
+    }
+
+    subscript(tag: UInt8) -> TagInfo? {
+        Int(tag) < tags.count ? tags[Int(tag)] : nil
+    }
+
+    /// Resolves a two digit tag string, `nil` for anything else
+    func tagInfo(for string: String) -> TagInfo? {
+        EMVQRTagTable.tag(from: string).flatMap { self[$0] }
+    }
+
+    /// Numeric value of a two digit tag string
+    static func tag(from string: String) -> UInt8? {
+        var utf8 = string.utf8.makeIterator()
+        guard let high = utf8.next(), let low = utf8.next(), utf8.next() == nil,
+              high &- 0x30 < 10, low &- 0x30 < 10 else {
+            return nil
+        }
+        return (high &- 0x30) * 10 + (low &- 0x30)
+    }
+
+    /// Table of the tags inside the top level template `rootTag`, the push payment table for `nil`
+    static func table(nestedIn rootTag: UInt8?) -> EMVQRTagTable? {
+        guard let rootTag = rootTag else {
+            return pushPayment
+        }
+        switch rootTag {
+        case 5:
+            return masterCard
+        case 26...51, 80...99:
+            return template
+        case 62:
+            return additionalData
+        case 64:
+            return language
+        default:
+            return nil
+        }
+    }
+
+    /// Shared table of a known `Tag` class, `nil` for any other class
+    static func table(for type: Tag.Type) -> EMVQRTagTable? {
+        switch ObjectIdentifier(type) {
+        case ObjectIdentifier(PPTag.self):
+            return pushPayment
+        case ObjectIdentifier(AdditionalDataTag.self):
+            return additionalData
+        case ObjectIdentifier(LanguageTag.self):
+            return language
+        case ObjectIdentifier(MasterCardDataTag.self):
+            return masterCard
+        case ObjectIdentifier(TemplateDataTag.self):
+            return template
+        default:
+            return nil
+        }
+    }
+
+    private static let otherTablesLock = NSLock()
+    private static var otherTables: [ObjectIdentifier: EMVQRTagTable] = [:]
+
+    /// `table(for:)`, or for any other `Tag` class a table built on first use and kept
+    static func cachedTable(for type: Tag.Type) -> EMVQRTagTable {
+        if let table = table(for: type) {
+            return table
+        }
+        otherTablesLock.lock()
+        defer { otherTablesLock.unlock() }
+        if let table = otherTables[ObjectIdentifier(type)] {
+            return table
+        }
+        let table = EMVQRTagTable(type)
+        otherTables[ObjectIdentifier(type)] = table
+        return table
+    }
+}
+
+extension TagUtility {
+    /// Table based `tagInfoFrom(_:of:)`. Returns `nil` instead of throwing `MPQRError.unknownTag`.
+    static func tagInfo(forTag string: String, of type: Tag.Type) -> TagInfo? {
+        if let table = EMVQRTagTable.table(for: type) {
+            return table.tagInfo(for: string)
+        }
+        return try? TagUtility.tagInfo(from: string, of: type)
+    }
+}
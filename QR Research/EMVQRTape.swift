@@ -0,0 +1,206 @@
+//
+//  EMVQRTape.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Structural tape of a payload: every TLV object in document order, templates followed by their children.
+/// Stage 1 (`init`) only checks tag and length headers and records positions; no string or SDK object is built.
+/// Stage 2 (`pushPaymentData()`) fills the SDK object graph from the entries and validates it, only when a graph is needed.
+struct EMVQRTape: RandomAccessCollection {
+    struct Entry: Equatable {
+        /// Numeric tag, 0...99
+        let tag: UInt8
+        /// 0 for top level objects, 1 inside a template
+        let depth: UInt8
+        /// Tag 05, 26...51, 62, 64 or 80...99 at the top level; its children follow on the tape
+        let isTemplate: Bool
+        /// Number of value bytes
+        let length: UInt16
+        /// Offset of the first value byte
+        let offset: UInt32
+        /// Index of the next entry at the same or a lower depth, so a template can be skipped in one step
+        fileprivate(set) var next: UInt32
+
+        var span: EMVQRSpan {
+            EMVQRSpan(tag: tag, offset: Int(offset), length: Int(length))
+        }
+    }
+
+    let bytes: [UInt8]
+    private(set) var entries: [Entry] = []
+
+    /// Builds the tape in one pass over `bytes`
+    /// - Note: Throws `EMVQRError.invalidFormat` on a malformed header or truncated value, at any depth
+    init(bytes: [UInt8]) throws {
+        self.bytes = bytes
+        entries.reserveCapacity(bytes.count / 6)
+        try EMVQRTape.scan(bytes, range: 0..<bytes.count, into: &entries)
+    }
+
+    init(string: String) throws {
+        try self.init(bytes: Array(string.utf8))
+    }
+
+    /// Stage 1 over `range` of `bytes`, appending to `entries`.
+    /// Offsets index `bytes` and `next` indices index `entries`, so the tapes of several payloads can share one array.
+    /// On error `entries` may hold a partial tape of the payload.
+    static func scan<Bytes: RandomAccessCollection>(_ bytes: Bytes, range: Range<Int>, into entries: inout [Entry]) throws
+        where Bytes.Element == UInt8, Bytes.Index == Int {
+        var scanner = EMVQRScanner(bytes: bytes, range: range)
+        while let span = try scanner.next() {
+            let isTemplate = EMVQRTagFormats.nested(in: span.tag) != nil
+            let index = entries.count
+            append(span, depth: 0, isTemplate: isTemplate, to: &entries)
+            if isTemplate {
+                var children = EMVQRScanner(bytes: bytes, range: span.offset..<span.end)
+                while let child = try children.next() {
+                    append(child, depth: 1, isTemplate: false, to: &entries)
+                }
+                entries[index].next = UInt32(entries.count)
+            }
+        }
+    }
+
+    private static func append(_ span: EMVQRSpan, depth: UInt8, isTemplate: Bool, to entries: inout [Entry]) {
+        entries.append(Entry(tag: span.tag, depth: depth, isTemplate: isTemplate,
+                             length: UInt16(span.length), offset: UInt32(span.offset),
+                             next: UInt32(entries.count + 1)))
+    }
+
+    // MARK: - RandomAccessCollection
+
+    var startIndex: Int {
+        entries.startIndex
+    }
+
+    var endIndex: Int {
+        entries.endIndex
+    }
+
+    subscript(position: Int) -> Entry {
+        entries[position]
+    }
+
+    // MARK: - Navigation
+
+    /// Indices of the top level objects, skipping template children
+    var topLevelIndices: UnfoldSequence<Int, Int> {
+        sequence(state: startIndex) { index -> Int? in
+            guard index < endIndex else {
+                return nil
+            }
+            defer { index = Int(entries[index].next) }
+            return index
+        }
+    }
+
+    /// Indices of the children of the template at `index`, empty for a primitive
+    func children(of index: Int) -> Range<Int> {
+        index + 1..<Int(entries[index].next)
+    }
+
+    /// Index of the top level object `tag`
+    func index(of tag: UInt8) -> Int? {
+        topLevelIndices.first { entries[$0].tag == tag }
+    }
+
+    /// Index of the object `tag` inside the template at `parent`
+    func index(of tag: UInt8, in parent: Int) -> Int? {
+        children(of: parent).first { entries[$0].tag == tag }
+    }
+
+    func value(at index: Int) -> String {
+        let entry = entries[index]
+        return String(decoding: bytes[Int(entry.offset)..<Int(entry.offset) + Int(entry.length)], as: UTF8.self)
+    }
+
+    /// Compares the value at `index` with `string` without building a `String`
+    func value(at index: Int, equals string: String) -> Bool {
+        EMVQRValidator.equals(bytes, entries[index].span, string)
+    }
+
+    // MARK: - Stage 2
+
+    /// Builds the SDK object graph from the tape entries and validates it, rejecting what `MPQRParser.parse(string:)` rejects.
+    /// The CRC trailer, duplicate and reserved tags are checked here; formats and mandatory tags by `validate()`.
+    /// Only the values become strings; the payload is not tokenised again.
+    /// - Note: Throws `EMVQRError` for the trailer, duplicate or reserved tags, and the `MPQRError` of `validate()`
+    func pushPaymentData() throws -> PushPaymentData {
+        try bytes.withUnsafeBytes { try EMVQRCRC16.validateTrailer(of: $0) }
+        let data = PushPaymentData()
+        try populate(data, with: topLevelIndices, rootTag: nil)
+        try data.validate()
+        return data
+    }
+
+    private func populate<Indices: Sequence>(_ data: AbstractData, with indices: Indices, rootTag: UInt8?) throws
+        where Indices.Element == Int {
+        let formats = rootTag.flatMap(EMVQRTagFormats.nested(in:)) ?? EMVQRTagFormats.pushPayment
+        let table = EMVQRTagTable.table(nestedIn: rootTag)
+        var seen = EMVQRTagStore()
+        for index in indices {
+            let span = entries[index].span
+            guard seen.insert(span) else {
+                throw EMVQRError.duplicateTag(tag: span.tag, offset: span.headerOffset, rootTag: rootTag)
+            }
+            guard formats[Int(span.tag)].kind != .reserved, let tagInfo = table?[span.tag] else {
+                throw EMVQRError.rfuTag(tag: span.tag, offset: span.headerOffset, rootTag: rootTag)
+            }
+            data.setTagInfoValue(try value(at: index, rootTag: rootTag), for: tagInfo)
+        }
+    }
+
+    /// Value of the entry at `index` as the SDK stores it: a template object or a string
+    private func value(at index: Int, rootTag: UInt8?) throws -> Any {
+        let entry = entries[index]
+        if entry.isTemplate {
+            let template = EMVQRTape.makeTemplate(entry.tag)
+            try populate(template, with: children(of: index), rootTag: entry.tag)
+            return template
+        }
+        if rootTag == EMVQRPayload.Tags.additionalData, EMVQRTagFormats.additionalData[Int(entry.tag)].kind == .template {
+            // Unreserved templates of additional data are one level below the tape
+            return try unrestrictedData(in: entry.span, rootTag: rootTag)
+        }
+        return value(at: index)
+    }
+
+    private func unrestrictedData(in span: EMVQRSpan, rootTag: UInt8?) throws -> UnrestrictedData {
+        let template = UnrestrictedData()
+        template.setRootTag(EMVQRBytes.tagString(span.tag))
+        var scanner = EMVQRScanner(bytes: bytes, range: span.offset..<span.end)
+        var seen = EMVQRTagStore()
+        while let sub = try scanner.next() {
+            guard seen.insert(sub) else {
+                throw EMVQRError.duplicateTag(tag: sub.tag, offset: sub.headerOffset, rootTag: rootTag)
+            }
+            guard let tagInfo = EMVQRTagTable.template[sub.tag] else {
+                throw EMVQRError.rfuTag(tag: sub.tag, offset: sub.headerOffset, rootTag: rootTag)
+            }
+            template.setTagInfoValue(String(decoding: bytes[sub.offset..<sub.end], as: UTF8.self), for: tagInfo)
+        }
+        return template
+    }
+
+    private static func makeTemplate(_ tag: UInt8) -> AbstractData {
+        switch tag {
+        case 5:
+            return MasterCardData()
+        case 62:
+            return AdditionalData()
+        case 64:
+            return LanguageData()
+        case 26...51:
+            let template = MAIData()
+            template.setRootTag(EMVQRBytes.tagString(tag))
+            return template
+        default:
+            let template = UnrestrictedData()
+            template.setRootTag(EMVQRBytes.tagString(tag))
+            return template
+        }
+    }
+}
@@ -0,0 +1,118 @@
+//
+//  EMVQRTemplate.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Immutable dynamic QR compiled from a `PushPaymentData`.
+/// Everything except the transaction amount (54), the bill number (62 sub tag 01) and the CRC is serialised once;
+/// `render` splices the variable fields in and resumes the CRC from the state cached after the fixed prefix.
+/// Safe to share between threads.
+final class EMVQRTemplate {
+    /// TLVs before tag 54
+    private let prefix: [UInt8]
+    private let prefixCRC: EMVQRCRC16
+    /// TLVs 55...61
+    private let middle: [UInt8]
+    /// Sub tags of 62 other than the bill number
+    private let additionalData: [UInt8]
+    private let additionalDataCharacters: Int
+    /// TLVs after 62, without the CRC
+    private let suffix: [UInt8]
+
+    /// Point of initiation is forced to dynamic (`12`); any amount, bill number and CRC in `payloadData` are dropped.
+    /// The compiled template is rendered once with a placeholder amount and run through `MPQRParser.parse(string:)`,
+    /// so base data missing e.g. tag 52, 53, 58 or a merchant identifier is rejected here rather than producing
+    /// non-compliant QRs; `render` then only has to check the amount and bill number.
+    /// - Note: Throws `EMVQRError.invalidTagValue` for an empty or overlong value, or `MPQRError` from validation
+    init(payloadData: PushPaymentData) throws {
+        let tags = EMVQRPayload.Tags.self
+        let initiation = tags.pointOfInitiationMethod
+        prefix = try EMVQRGenerator.serialize(payloadData, in: 0...initiation - 1)
+            + EMVQRGenerator.serialize(tag: initiation, value: EMVQRConstants.pointOfInitiationMethodDynamic)
+            + EMVQRGenerator.serialize(payloadData, in: initiation + 1...tags.transactionAmount - 1)
+        middle = try EMVQRGenerator.serialize(payloadData, in: tags.transactionAmount + 1...tags.additionalData - 1)
+        // 63 is the CRC, recomputed by `render`
+        suffix = try EMVQRGenerator.serialize(payloadData, in: tags.crc + 1...99)
+
+        if let additional = EMVQRTagTable.pushPayment[tags.additionalData].flatMap(payloadData.getTagInfoValue(for:)) as? AbstractData {
+            additionalData = try EMVQRGenerator.serialize(additional, skipping: tags.billNumber)
+            additionalDataCharacters = try EMVQRGenerator.measure(additional, skipping: tags.billNumber).characters
+        } else {
+            additionalData = []
+            additionalDataCharacters = 0
+        }
+
+        var crc = EMVQRCRC16()
+        crc.update(prefix)
+        prefixCRC = crc
+
+        _ = try MPQRParser.parse(string: renderString(amount: EMVQRTemplate.placeholderAmount))
+    }
+
+    /// Amount rendered to validate the base data; any valid amount would do
+    private static let placeholderAmount = "1"
+
+    /// - Note: Throws `EMVQRError.invalidTagValue` if the amount or bill number does not match its tag format
+    func render(amount: String, billNumber: String? = nil) throws -> [UInt8] {
+        let tags = EMVQRPayload.Tags.self
+        var amount = amount
+        let amountCount = amount.utf8.count
+        let isValidAmount = amount.withUTF8 { EMVQRTagFormats.pushPayment[Int(tags.transactionAmount)].matches(UnsafeRawBufferPointer($0)) }
+        guard isValidAmount else {
+            throw EMVQRError.invalidTagValue(tag: tags.transactionAmount, offset: prefix.count + 4)
+        }
+
+        var billNumber = billNumber
+        let billCount = billNumber?.utf8.count ?? 0
+        if billNumber != nil {
+            let isValidBillNumber = billNumber!.withUTF8 { EMVQRTagFormats.additionalData[Int(tags.billNumber)].matches(UnsafeRawBufferPointer($0)) }
+            guard isValidBillNumber else {
+                throw EMVQRError.invalidTagValue(tag: tags.billNumber, offset: 0)
+            }
+        }
+
+        let billBytes = billNumber == nil ? 0 : 4 + billCount
+        let additionalCharacters = billBytes + additionalDataCharacters
+        guard additionalCharacters <= 99 else {
+            throw EMVQRError.invalidTagValue(tag: tags.additionalData, offset: 0)
+        }
+        let additionalBytes = billBytes + additionalData.count
+
+        let size = prefix.count + 4 + amountCount + middle.count
+            + (additionalBytes > 0 ? 4 + additionalBytes : 0)
+            + suffix.count + EMVQRCRC16.trailer.count + 4
+        return [UInt8](unsafeUninitializedCapacity: size) { buffer, initializedCount in
+            var writer = EMVQRGenerator.Writer(buffer: buffer)
+            writer.write(prefix)
+
+            writer.writeDigits(Int(tags.transactionAmount))
+            writer.writeDigits(amountCount)
+            writer.write(amount.utf8)
+            writer.write(middle)
+            if additionalBytes > 0 {
+                writer.writeDigits(Int(tags.additionalData))
+                writer.writeDigits(additionalCharacters)
+                if let billNumber = billNumber {
+                    writer.writeDigits(Int(tags.billNumber))
+                    writer.writeDigits(billCount)
+                    writer.write(billNumber.utf8)
+                }
+                writer.write(additionalData)
+            }
+            writer.write(suffix)
+
+            let rendered = UnsafeRawBufferPointer(UnsafeMutableBufferPointer(rebasing: buffer[prefix.count..<writer.position]))
+            let crc = prefixCRC.finalized(appending: rendered)
+            writer.write(EMVQRCRC16.trailer)
+            writer.write(EMVQRCRC16.hexString(crc).utf8)
+            initializedCount = writer.position
+        }
+    }
+
+    func renderString(amount: String, billNumber: String? = nil) throws -> String {
+        String(decoding: try render(amount: amount, billNumber: billNumber), as: UTF8.self)
+    }
+}
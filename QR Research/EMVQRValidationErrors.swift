@@ -0,0 +1,25 @@
+//
+//  EMVQRValidationErrors.swift
+//  QR Research
+//
+
+import Foundation
+
+/// Validation errors of a single parse.
+/// Unlike the class level `ParserValidationErrors` it is owned by the call,
+/// so parses running on different threads never share mutable state.
+final class EMVQRValidationErrors {
+    private(set) var errors: [EMVQRError] = []
+
+    var isEmpty: Bool {
+        errors.isEmpty
+    }
+
+    func add(_ error: EMVQRError) {
+        errors.append(error)
+    }
+
+    func removeAll() {
+        errors.removeAll(keepingCapacity: true)
+    }
+}
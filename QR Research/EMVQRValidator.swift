@@ -0,0 +1,166 @@
+//
+//  EMVQRValidator.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Validates the top level template of a scanned payload.
+/// Follows the rules of `PushPaymentData.validate`, but reports every failure
+/// to the caller's `EMVQRValidationErrors` instead of stopping at the first one.
+enum EMVQRValidator {
+    static let mandatoryTags: [UInt8] = [0, 52, 53, 58, 59, 60, 63]
+    static let merchantIdentifierTags: ClosedRange<UInt8> = 2...51
+    static let crcTag: UInt8 = 63
+    static let transactionAmountTag: UInt8 = 54
+    static let pointOfInitiationTag: UInt8 = 1
+    static let tipIndicatorTag: UInt8 = 55
+    static let convenienceFeeFixedTag: UInt8 = 56
+    static let convenienceFeePercentageTag: UInt8 = 57
+
+    static func validate(bytes: [UInt8], spans: [EMVQRSpan], into errors: EMVQRValidationErrors) {
+        var present = EMVQRTagStore()
+        for span in spans {
+            if !present.insert(span) {
+                errors.add(.duplicateTag(tag: span.tag, offset: span.headerOffset))
+            }
+        }
+
+        for tag in mandatoryTags where !present.contains(tag) {
+            errors.add(.missingTag(tag: tag))
+        }
+
+        for span in spans {
+            validateFormat(bytes: bytes, span: span, formats: EMVQRTagFormats.pushPayment, rootTag: nil, into: errors)
+        }
+
+        if let first = spans.first, first.tag != 0 {
+            errors.add(.invalidTagValue(tag: first.tag, offset: first.headerOffset))
+        }
+
+        if let crc = present[crcTag] {
+            if spans.last?.tag != crcTag || crc.length != 4 {
+                errors.add(.invalidTagValue(tag: crcTag, offset: crc.headerOffset))
+            } else if !ChecksumUtility.isValidCrc16(bytes: bytes) {
+                errors.add(.invalidTagValue(tag: crcTag, offset: crc.offset, length: crc.length))
+            }
+        }
+
+        if !present.containsAny(in: merchantIdentifierTags) {
+            errors.add(.missingTag(tag: merchantIdentifierTags.lowerBound))
+        }
+
+        validatePriceField(bytes: bytes, present: present, into: errors)
+        validateTipFields(bytes: bytes, present: present, into: errors)
+    }
+
+    /// Checks the value of `span` against its cached format and, for top level templates,
+    /// every TLV inside the template
+    /// - Parameter rootTag: Top level template holding `span`, `nil` for a top level TLV
+    private static func validateFormat(bytes: [UInt8], span: EMVQRSpan, formats: [EMVQRTagFormat],
+                                       rootTag: UInt8?, into errors: EMVQRValidationErrors) {
+        let format = formats[Int(span.tag)]
+        if format.kind == .reserved {
+            errors.add(.rfuTag(tag: span.tag, offset: span.headerOffset, rootTag: rootTag))
+            return
+        }
+
+        let isValid = bytes.withUnsafeBytes { buffer in
+            format.matches(UnsafeRawBufferPointer(rebasing: buffer[span.offset..<span.end]))
+        }
+        guard isValid else {
+            errors.add(.invalidTagValue(tag: span.tag, offset: span.offset, length: span.length, rootTag: rootTag))
+            return
+        }
+
+        if rootTag == nil, format.kind == .template, let nested = EMVQRTagFormats.nested(in: span.tag) {
+            validateTemplate(bytes: bytes, span: span, formats: nested, into: errors)
+        }
+    }
+
+    private static func validateTemplate(bytes: [UInt8], span: EMVQRSpan, formats: [EMVQRTagFormat],
+                                         into errors: EMVQRValidationErrors) {
+        var scanner = EMVQRScanner(bytes: bytes, range: span.offset..<span.end)
+        var seen = EMVQRTagStore()
+        do {
+            while let sub = try scanner.next() {
+                if !seen.insert(sub) {
+                    errors.add(.duplicateTag(tag: sub.tag, offset: sub.headerOffset, rootTag: span.tag))
+                }
+                validateFormat(bytes: bytes, span: sub, formats: formats, rootTag: span.tag, into: errors)
+            }
+        } catch let error as EMVQRError {
+            errors.add(error)
+        } catch {
+            errors.add(.invalidFormat(offset: scanner.position))
+        }
+
+        for tag in mandatorySubTags(of: span.tag) where !seen.contains(tag) {
+            errors.add(.missingTag(tag: tag, rootTag: span.tag))
+        }
+    }
+
+    private static func mandatorySubTags(of tag: UInt8) -> [UInt8] {
+        switch tag {
+        case 26...51, 80...99:
+            return [0]
+        case 64:
+            return [0, 1]
+        default:
+            return []
+        }
+    }
+
+    private static func validatePriceField(bytes: [UInt8], present: EMVQRTagStore, into errors: EMVQRValidationErrors) {
+        let isDynamic = present[pointOfInitiationTag].map {
+            equals(bytes, $0, EMVQRConstants.pointOfInitiationMethodDynamic)
+        } ?? false
+        let hasAmount = present.contains(transactionAmountTag)
+
+        if isDynamic && !hasAmount {
+            errors.add(.missingTag(tag: transactionAmountTag))
+        } else if !isDynamic && hasAmount {
+            errors.add(.conflictingTag(tag: transactionAmountTag))
+        }
+    }
+
+    private static func validateTipFields(bytes: [UInt8], present: EMVQRTagStore, into errors: EMVQRValidationErrors) {
+        guard let indicator = present[tipIndicatorTag] else {
+            return
+        }
+        let hasFixed = present.contains(convenienceFeeFixedTag)
+        let hasPercentage = present.contains(convenienceFeePercentageTag)
+
+        if equals(bytes, indicator, "01") {
+            if hasFixed {
+                errors.add(.conflictingTag(tag: convenienceFeeFixedTag))
+            }
+            if hasPercentage {
+                errors.add(.conflictingTag(tag: convenienceFeePercentageTag))
+            }
+        } else if equals(bytes, indicator, "02") {
+            if !hasFixed {
+                errors.add(.missingTag(tag: convenienceFeeFixedTag))
+            }
+            if hasPercentage {
+                errors.add(.conflictingTag(tag: convenienceFeePercentageTag))
+            }
+        } else if equals(bytes, indicator, "03") {
+            if !hasPercentage {
+                errors.add(.missingTag(tag: convenienceFeePercentageTag))
+            }
+            if hasFixed {
+                errors.add(.conflictingTag(tag: convenienceFeeFixedTag))
+            }
+        } else {
+            errors.add(.invalidTagValue(tag: tipIndicatorTag, offset: indicator.offset, length: indicator.length))
+        }
+    }
+
+    @inline(__always)
+    static func equals<Bytes: RandomAccessCollection>(_ bytes: Bytes, _ span: EMVQRSpan, _ string: String) -> Bool
+        where Bytes.Element == UInt8, Bytes.Index == Int {
+        span.length == string.utf8.count && string.utf8.elementsEqual(bytes[span.offset..<span.end])
+    }
+}
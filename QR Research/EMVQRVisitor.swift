@@ -0,0 +1,62 @@
+//
+//  EMVQRVisitor.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Receives one event per TLV object while `MPQRParser.walk` reads a payload.
+/// A template is reported first with its whole value, then each of its objects with `parentTag` set.
+/// `value` points into the payload and is only valid during the call; throw to stop the walk.
+protocol EMVQRVisitor {
+    mutating func onTag(_ tag: UInt8, value: UnsafeRawBufferPointer, parentTag: UInt8?) throws
+}
+
+/// Adapts a closure to `EMVQRVisitor`
+struct EMVQRClosureVisitor: EMVQRVisitor {
+    let body: (UInt8, UnsafeRawBufferPointer, UInt8?) throws -> Void
+
+    func onTag(_ tag: UInt8, value: UnsafeRawBufferPointer, parentTag: UInt8?) throws {
+        try body(tag, value, parentTag)
+    }
+}
+
+extension MPQRParser {
+    /// Walks `payload` depth first without building strings or SDK objects.
+    /// Descends into master card data (05), merchant account information (26...51), additional data (62),
+    /// language data (64) and unreserved templates (80...99), and into the unreserved templates (50...99) of additional data.
+    /// - Note: Throws `EMVQRError.invalidFormat` on a malformed header or truncated value, or whatever `visitor` throws
+    static func walk<Visitor: EMVQRVisitor>(payload: UnsafeRawBufferPointer, visitor: inout Visitor) throws {
+        try walk(payload, range: 0..<payload.count, formats: EMVQRTagFormats.pushPayment, parentTag: nil, visitor: &visitor)
+    }
+
+    /// - Note: The walk reads the string's UTF-8 storage in place, so a native Swift string is not copied
+    static func walk<Visitor: EMVQRVisitor>(string: String, visitor: inout Visitor) throws {
+        var string = string
+        try string.withUTF8 { try walk(payload: UnsafeRawBufferPointer($0), visitor: &visitor) }
+    }
+
+    static func walk(string: String, onTag body: (UInt8, UnsafeRawBufferPointer, UInt8?) throws -> Void) throws {
+        try withoutActuallyEscaping(body) { body in
+            var visitor = EMVQRClosureVisitor(body: body)
+            try walk(string: string, visitor: &visitor)
+        }
+    }
+
+    private static func walk<Visitor: EMVQRVisitor>(_ payload: UnsafeRawBufferPointer, range: Range<Int>,
+                                                    formats: [EMVQRTagFormat], parentTag: UInt8?,
+                                                    visitor: inout Visitor) throws {
+        var scanner = EMVQRScanner(bytes: payload, range: range)
+        while let span = try scanner.next() {
+            try visitor.onTag(span.tag, value: UnsafeRawBufferPointer(rebasing: payload[span.offset..<span.end]), parentTag: parentTag)
+            guard formats[Int(span.tag)].kind == .template else {
+                continue
+            }
+            let nested = parentTag == nil ? EMVQRTagFormats.nested(in: span.tag) : EMVQRTagFormats.template
+            if let nested = nested {
+                try walk(payload, range: span.offset..<span.end, formats: nested, parentTag: span.tag, visitor: &visitor)
+            }
+        }
+    }
+}
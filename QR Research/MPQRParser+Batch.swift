@@ -0,0 +1,90 @@
+//
+//  MPQRParser+Batch.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+/// Throughput counters of one batch parse
+struct EMVQRBatchStatistics {
+    let count: Int
+    let failures: Int
+    let bytes: Int
+    let elapsed: TimeInterval
+
+    var itemsPerSecond: Double {
+        elapsed > 0 ? Double(count) / elapsed : 0
+    }
+
+    var bytesPerSecond: Double {
+        elapsed > 0 ? Double(bytes) / elapsed : 0
+    }
+}
+
+/// Results of a batch parse, in input order
+struct EMVQRBatchResult {
+    let results: [Result<PushPaymentData, Error>]
+    let statistics: EMVQRBatchStatistics
+}
+
+extension MPQRParser {
+    /// Upper bound of strings handed to a worker at a time
+    static let batchChunkSize = 64
+
+    /// Parses `strings` on all cores.
+    /// The input is cut into small chunks that GCD's worker pool picks up as threads free up,
+    /// so a few slow payloads do not hold back the rest. Results keep the input order.
+    /// - Parameter parse: Parser used for every item, `parse(string:)` by default. Must be safe to call concurrently.
+    static func parseBatch(strings: [String],
+                           parse: (String) throws -> PushPaymentData = { try MPQRParser.parse(string: $0) }) -> EMVQRBatchResult {
+        let count = strings.count
+        let start = DispatchTime.now().uptimeNanoseconds
+        let workers = ProcessInfo.processInfo.activeProcessorCount
+        let chunkSize = max(1, min(batchChunkSize, count / max(1, workers * 4)))
+        let chunks = (count + chunkSize - 1) / chunkSize
+
+        let results = [Result<PushPaymentData, Error>](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+            let base = buffer.baseAddress
+            DispatchQueue.concurrentPerform(iterations: chunks) { chunk in
+                let lower = chunk * chunkSize
+                let upper = min(lower + chunkSize, count)
+                for index in lower..<upper {
+                    base?.advanced(by: index).initialize(to: Result { try parse(strings[index]) })
+                }
+            }
+            initializedCount = count
+        }
+
+        let elapsed = TimeInterval(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000
+        let failures = results.reduce(0) { failures, result in
+            if case .failure = result {
+                return failures + 1
+            }
+            return failures
+        }
+        let bytes = strings.reduce(0) { $0 + $1.utf8.count }
+        let statistics = EMVQRBatchStatistics(count: count, failures: failures, bytes: bytes, elapsed: elapsed)
+        return EMVQRBatchResult(results: results, statistics: statistics)
+    }
+
+    /// Parses a newline delimited buffer of QR strings. `\r\n` line endings are accepted.
+    /// `results[i]` is always line `i` of the buffer: an empty line is kept as an `EMVQRError.invalidFormat` failure.
+    static func parseBatch(data: Data,
+                           parse: (String) throws -> PushPaymentData = { try MPQRParser.parse(string: $0) }) -> EMVQRBatchResult {
+        var lines = data.split(separator: 0x0A, omittingEmptySubsequences: false)
+        if lines.last?.isEmpty == true {
+            // Terminator of the last line, not a line of its own
+            lines.removeLast()
+        }
+        let strings: [String] = lines.map { line in
+            String(decoding: line.last == 0x0D ? line.dropLast() : line, as: UTF8.self)
+        }
+        return parseBatch(strings: strings) { string in
+            guard !string.isEmpty else {
+                throw EMVQRError.invalidFormat(offset: 0)
+            }
+            return try parse(string)
+        }
+    }
+}
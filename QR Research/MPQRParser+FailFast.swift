@@ -0,0 +1,29 @@
+//
+//  MPQRParser+FailFast.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+extension MPQRParser {
+    /// `parse(string:)` behind a CRC check on the raw bytes.
+    /// Most camera misreads fail the CRC, and are rejected here before the SDK tokenises the payload
+    /// or builds any object.
+    /// - Note: Throws `EMVQRError.missingTag` or `.invalidTagValue` for the CRC, otherwise what `parse(string:)` throws
+    static func parseFailFast(string: String) throws -> PushPaymentData {
+        try validateCRCFirst(string)
+        return try MPQRParser.parse(string: string)
+    }
+
+    /// `parseWithValidationWarnings(string:errors:)` behind the same CRC check
+    static func parseFailFast(string: String, errors: EMVQRValidationErrors) throws -> PushPaymentData {
+        try validateCRCFirst(string)
+        return try MPQRParser.parseWithValidationWarnings(string: string, errors: errors)
+    }
+
+    /// Reads the string's UTF-8 in place, so a bridged camera string is not copied just to be rejected
+    private static func validateCRCFirst(_ string: String) throws {
+        try EMVQRCRC16.validateTrailer(of: string)
+    }
+}
@@ -0,0 +1,54 @@
+//
+//  MPQRParser+Scanner.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+extension MPQRParser {
+    /// Reads all top level TLV objects of `string` in one pass.
+    /// Unlike `readNextTLV(_:start:tagType:)` no `NSString` is built for tag, length or value:
+    /// the payload is copied to a byte buffer once and every `EMVQRTLV` refers into it.
+    /// - Note: Throws `EMVQRError.invalidFormat` on a malformed header or truncated value
+    static func scanTLVs(string: String) throws -> [EMVQRTLV] {
+        let bytes = Array(string.utf8)
+        var scanner = EMVQRScanner(bytes: bytes)
+        var tlvs: [EMVQRTLV] = []
+        tlvs.reserveCapacity(bytes.count / 8)
+        while let span = try scanner.next() {
+            tlvs.append(EMVQRTLV(bytes: bytes, span: span))
+        }
+        return tlvs
+    }
+}
+
+extension MPQRParser {
+    /// Scans the top level template only. Nested templates are decoded when first read from the result.
+    /// - Parameter validatesCRC: Checks tag 63 against the payload, as `parseWithoutTagValidation` does.
+    ///   The CRC is checked before scanning, so a corrupted payload costs one CRC pass.
+    /// - Note: Throws `EMVQRError.invalidFormat`, `.duplicateTag`, `.missingTag` or `.invalidTagValue` for the CRC
+    static func parseLazily(string: String, validatesCRC: Bool = true) throws -> EMVQRPayload {
+        let bytes = Array(string.utf8)
+        if validatesCRC {
+            try bytes.withUnsafeBytes { try EMVQRCRC16.validateTrailer(of: $0) }
+        }
+        let data = try EMVQRData(bytes: bytes)
+        if validatesCRC {
+            // The trailer could also be the end of another object's value
+            guard let crc = data.span(for: EMVQRPayload.Tags.crc), crc.end == bytes.count else {
+                throw EMVQRError.invalidTagValue(tag: EMVQRPayload.Tags.crc, offset: bytes.count)
+            }
+        }
+        return EMVQRPayload(data: data)
+    }
+}
+
+extension MPQRParser {
+    /// Stage 1 of the two stage parser: the structural tape of `string`, templates included.
+    /// Call `EMVQRTape.pushPaymentData()` for the object graph.
+    /// - Note: Throws `EMVQRError.invalidFormat` on a malformed header or truncated value
+    static func parseTape(string: String) throws -> EMVQRTape {
+        try EMVQRTape(string: string)
+    }
+}
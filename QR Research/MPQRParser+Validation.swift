@@ -0,0 +1,30 @@
+//
+//  MPQRParser+Validation.swift
+//  QR Research
+//
+
+import Foundation
+import MPQRCoreSDK
+
+extension MPQRParser {
+    /// Thread safe variant of `parseWithValidationWarnings(string:)`.
+    /// Validation errors go to `errors`, which belongs to the caller, and are copied to
+    /// `PushPaymentData.validationErrors`. The SDK's global `ParserValidationErrors` is never touched,
+    /// so concurrent parses need no lock. `errors` is cleared first, so one sink can be reused across parses.
+    /// - Note: Throws `EMVQRError.invalidFormat` if the payload cannot be tokenised, or `MPQRError` from the SDK
+    static func parseWithValidationWarnings(string: String, errors: EMVQRValidationErrors) throws -> PushPaymentData {
+        errors.removeAll()
+        let bytes = Array(string.utf8)
+        var scanner = EMVQRScanner(bytes: bytes)
+        var spans: [EMVQRSpan] = []
+        while let span = try scanner.next() {
+            spans.append(span)
+        }
+
+        EMVQRValidator.validate(bytes: bytes, spans: spans, into: errors)
+
+        let payloadData = try MPQRParser.parseWithoutTagValidationAndCRC(string)
+        payloadData.validationErrors = errors.isEmpty ? nil : errors.errors.map { $0.mpqrError(payload: bytes) }
+        return payloadData
+    }
+}
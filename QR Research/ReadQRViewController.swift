@@ -34,27 +34,21 @@ class ReadQRViewController: UIViewController {
     
     
     func receive(metadata: String) {
+        // Scanner strings are bridged from NSString; make the UTF-8 native once for the reads below
+        var metadata = metadata
+        metadata.makeContiguousUTF8()
         do {
-            let payloadData = try MPQRParser.parse(string: metadata)
-            
-            // Print data in string format
-                 print(payloadData.dumpData())
+            // Full SDK validation before anything reaches the payment flow; the intent then reads the fields
+            _ = try MPQRParser.parseFailFast(string: metadata)
+            let intent = try EMVQRPaymentIntent.extract(from: metadata)
 
-            var maiData: MAIData?
-            for value in EMVQRConstants.availableIDTags {
-                if let item = try? payloadData.getMAIData(forTagString: value) {
-                    maiData = item
-                    break
-                }
-            }
-
-            guard let accountId = maiData?.AID else {
+            guard let accountId = intent.value(.aid, in: metadata) else {
 //                restartScan()
                 return
             }
 
             var assetId: String?
-            if let codeString = payloadData.transactionCurrencyCode,
+            if let codeString = intent.value(.currency, in: metadata),
                 let code = Int16(codeString) {
                 let asset: CurrencyType.Type = CurrencyFactory.from(iso: code)
                 assetId = asset.assetId
@@ -63,13 +57,13 @@ class ReadQRViewController: UIViewController {
             var description: String?
 
             let trimSet = CharacterSet(charactersIn: " ")
-            let merchantName = payloadData.merchantName ?? EMVQRConstants.merchantDefaultName
-            if let purpose = payloadData.additionalData?.purpose,
+            let merchantName = intent.value(.merchantName, in: metadata) ?? EMVQRConstants.merchantDefaultName
+            if let purpose = intent.value(.purpose, in: metadata),
                 !purpose.trimmingCharacters(in: trimSet).isEmpty {
                 description = purpose
             }
 
-            if let billNumber = payloadData.additionalData?.billNumber?.trimmingCharacters(in: trimSet) {
+            if let billNumber = intent.value(.billNumber, in: metadata)?.trimmingCharacters(in: trimSet) {
                 if (description ?? "").isEmpty {
                     description = billNumber
                 } else {
@@ -77,12 +71,12 @@ class ReadQRViewController: UIViewController {
                 }
             }
 
-            print("\(assetId) , \(payloadData.transactionAmount), \(description), \(accountId) , \(merchantName), \(metadata)")
+            print("\(assetId) , \(intent.value(.amount, in: metadata)), \(description), \(accountId) , \(merchantName), \(metadata)")
 
 //            receiveQR(
 //                payload: QRPayload(
 //                    assetId: assetId,
-//                        amount: payloadData.transactionAmount,
+//                        amount: intent.value(.amount, in: metadata),
 //                        description: description,
 //                        recipientId: accountId,
 //                        merchantName: merchantName,